@@ -0,0 +1,181 @@
+/**
+ * @file deadline.h
+ * @author vc (VchaseNi@gmail.com)
+ * @brief 任务截止时间存储，以结构体数组(SoA)的方式连续保存任务下一次需要检查的时间戳，
+ *        每次tick连续扫描(开启AVX2时使用SIMD比较，否则标量)找出到期任务，避免逐个访问任务列表节点
+ *        备注：
+ *          1. 未运行的任务截止时间为DeadlineNever，不会被检出；
+ *          2. AVX2版本需编译时开启对应指令集(如 -mavx2 或 -march=native)；SSE4.2版本实测不快于标量，未提供；
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __VC_DEADLINE__
+#define __VC_DEADLINE__
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace vcTimer {
+
+const int64_t DeadlineNever = std::numeric_limits<int64_t>::max(); // 永不到期
+
+class DeadlineStore {
+public:
+    /**
+     * @brief 添加任务，初始截止时间为DeadlineNever
+     *
+     * @param key: 任务标识，不能为0
+     * @return uint32_t: 任务所在槽位
+     */
+    uint32_t add(uint32_t key)
+    {
+        m_deadline.push_back(DeadlineNever);
+        m_key.push_back(key);
+        return static_cast<uint32_t>(m_key.size() - 1);
+    }
+
+    /**
+     * @brief 移除任务，最后一个任务被移动到该槽位
+     *
+     * @param slot: 任务所在槽位
+     * @return uint32_t: 被移动到该槽位的任务标识，没有任务移动时为0
+     */
+    uint32_t remove(uint32_t slot)
+    {
+        uint32_t moved = 0;
+        if (slot + 1 != m_key.size()) {
+            m_deadline[slot] = m_deadline.back();
+            m_key[slot] = m_key.back();
+            moved = m_key[slot];
+        }
+        m_deadline.pop_back();
+        m_key.pop_back();
+        return moved;
+    }
+
+    /**
+     * @brief 更新任务的截止时间
+     *
+     * @param slot: 任务所在槽位
+     * @param deadline: 截止时间戳，不能为负数(SIMD版本依赖此条件屏蔽到期任务)
+     */
+    void update(uint32_t slot, int64_t deadline)
+    {
+        m_deadline[slot] = deadline;
+        m_minDeadline = std::min(m_minDeadline, deadline);
+    }
+
+    /**
+     * @brief 找出所有到期(截止时间 <= curStamp)的任务
+     *
+     * @param curStamp: 当前时间戳
+     * @param due: 输出到期任务的标识，按槽位顺序
+     */
+    void collectDue(int64_t curStamp, std::vector<uint32_t> &due)
+    {
+        due.clear();
+        if (curStamp < m_minDeadline) {
+            return; // 没有任务到期，无需扫描
+        }
+#if defined(__AVX2__)
+        m_minDeadline = collectDueAvx2(curStamp, due);
+#else
+        m_minDeadline = collectDueScalar(curStamp, due, 0);
+#endif
+    }
+
+    size_t size() const { return m_key.size(); }
+
+private:
+    /**
+     * @brief 标量扫描
+     *
+     * @param curStamp: 当前时间戳
+     * @param due: 输出到期任务的标识
+     * @param begin: 开始扫描的槽位
+     * @return int64_t: 未到期任务中最小的截止时间
+     */
+    int64_t collectDueScalar(int64_t curStamp, std::vector<uint32_t> &due, size_t begin) const
+    {
+        int64_t minDeadline = DeadlineNever;
+        for (size_t i = begin; i < m_deadline.size(); i++) {
+            if (m_deadline[i] <= curStamp) {
+                due.push_back(m_key[i]);
+            }
+            else {
+                minDeadline = std::min(minDeadline, m_deadline[i]);
+            }
+        }
+        return minDeadline;
+    }
+
+#if defined(__AVX2__)
+    /**
+     * @brief AVX2扫描，每次处理8个任务：比较结果通过movemask判断，仅在有任务到期时(少数情况)逐个收集并屏蔽到期任务；
+     *        两个最小值累加器交替更新，避免单一依赖链限制吞吐
+     *
+     * @param curStamp: 当前时间戳
+     * @param due: 输出到期任务的标识
+     * @return int64_t: 未到期任务中最小的截止时间
+     */
+    int64_t collectDueAvx2(int64_t curStamp, std::vector<uint32_t> &due) const
+    {
+        const size_t cnt = m_deadline.size() & ~size_t(7);
+        const __m256i cur = _mm256_set1_epi64x(curStamp);
+        const __m256i never = _mm256_set1_epi64x(DeadlineNever);
+        __m256i min0 = never;
+        __m256i min1 = never;
+        for (size_t i = 0; i < cnt; i += 8) {
+            __m256i d0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&m_deadline[i]));
+            __m256i d1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&m_deadline[i + 4]));
+            __m256i notDue0 = _mm256_cmpgt_epi64(d0, cur);
+            __m256i notDue1 = _mm256_cmpgt_epi64(d1, cur);
+            int mask = ~(_mm256_movemask_pd(_mm256_castsi256_pd(notDue0)) |
+                         _mm256_movemask_pd(_mm256_castsi256_pd(notDue1)) << 4) &
+                       0xFF;
+            if (mask != 0) {
+                collectMask(i, mask, due);
+                // 截止时间非负，或上DeadlineNever后即为DeadlineNever，使到期任务不参与求最小值
+                d0 = _mm256_or_si256(d0, _mm256_andnot_si256(notDue0, never));
+                d1 = _mm256_or_si256(d1, _mm256_andnot_si256(notDue1, never));
+            }
+            min0 = _mm256_blendv_epi8(min0, d0, _mm256_cmpgt_epi64(min0, d0));
+            min1 = _mm256_blendv_epi8(min1, d1, _mm256_cmpgt_epi64(min1, d1));
+        }
+        min0 = _mm256_blendv_epi8(min0, min1, _mm256_cmpgt_epi64(min0, min1));
+        alignas(32) int64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), min0);
+        int64_t minDeadline = std::min(std::min(lanes[0], lanes[1]), std::min(lanes[2], lanes[3]));
+        return std::min(minDeadline, collectDueScalar(curStamp, due, cnt));
+    }
+
+    /**
+     * @brief 按比较掩码收集到期任务
+     *
+     * @param begin: 掩码第0位对应的槽位
+     * @param mask: 到期掩码，第n位为1表示槽位begin+n到期
+     * @param due: 输出到期任务的标识
+     */
+    void collectMask(size_t begin, int mask, std::vector<uint32_t> &due) const
+    {
+        while (mask) {
+            due.push_back(m_key[begin + __builtin_ctz(mask)]);
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+private:
+    std::vector<int64_t> m_deadline;           // 任务截止时间，与m_key按槽位一一对应
+    std::vector<uint32_t> m_key;               // 任务标识
+    int64_t m_minDeadline{DeadlineNever};      // 截止时间的下界，当前时间小于它时跳过扫描
+};
+}; // namespace vcTimer
+#endif
@@ -0,0 +1,208 @@
+/**
+ * @file delayQueue.h
+ * @author vc (VchaseNi@gmail.com)
+ * @brief 延迟队列，用于大量"延迟一段时间后处理"的数据(如重试、限流)，无需为每条数据创建任务和可调用对象
+ *        备注：
+ *          1. 数据按到期时间(相同时按写入顺序)有序出队，直接保存在连续内存的最小堆中；
+ *          2. 时间戳与TimerService一致，可共享simulated模式的TimerService，advance()推进时钟时唤醒阻塞在pop()的消费者；
+ *          3. 消费者可阻塞等待pop()，或批量读取已到期的数据popReady()；pop()的超时时间始终为真实时间；
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __VC_DELAY_QUEUE__
+#define __VC_DELAY_QUEUE__
+#include "service.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace vcTimer {
+
+template <typename T>
+class DelayQueue {
+public:
+    /**
+     * @brief Construct a new Delay Queue object
+     *
+     * @param service: 提供时钟的定时器服务，为空时使用系统时钟
+     */
+    explicit DelayQueue(std::shared_ptr<TimerService> service = nullptr) : m_service(std::move(service))
+    {
+        if (isSimulated()) {
+            m_listener = m_service->addClockListener([this]() {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex); // 避免唤醒丢失
+                }
+                m_cv.notify_all();
+            });
+        }
+    }
+
+    ~DelayQueue()
+    {
+        if (m_listener != 0) {
+            m_service->removeClockListener(m_listener);
+        }
+    }
+
+    DelayQueue(const DelayQueue &) = delete;
+    DelayQueue &operator=(const DelayQueue &) = delete;
+
+    /**
+     * @brief 写入数据
+     *
+     * @param item: 数据
+     * @param delay: 延迟时间(ms)
+     */
+    void push(T item, int64_t delay) { emplace(delay, std::move(item)); }
+
+    /**
+     * @brief 原地构造数据
+     *
+     * @tparam A: 数据构造参数模板参数
+     * @param delay: 延迟时间(ms)
+     * @param args: 数据构造参数
+     */
+    template <typename... A>
+    void emplace(int64_t delay, A &&...args)
+    {
+        int64_t deadline = now() + delay;
+        bool isEarliest = false;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            uint64_t seq = m_seq++;
+            m_heap.push_back(Entry{deadline, seq, T(std::forward<A>(args)...)});
+            std::push_heap(m_heap.begin(), m_heap.end(), Later{});
+            isEarliest = m_heap.front().seq == seq;
+        }
+        if (isEarliest) {
+            m_cv.notify_one(); // 最早到期的数据变化，唤醒等待的消费者重新计算等待时间
+        }
+    }
+
+    /**
+     * @brief 批量读取已到期的数据，按到期顺序追加到out末尾，不阻塞
+     *
+     * @param out: 输出数据
+     * @param max: 最多读取的数量
+     * @return size_t: 读取的数量
+     */
+    size_t popReady(std::vector<T> &out, size_t max = SIZE_MAX)
+    {
+        int64_t curStamp = now();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t cnt = 0;
+        while (cnt < max && !m_heap.empty() && m_heap.front().deadline <= curStamp) {
+            out.push_back(popFront());
+            cnt++;
+        }
+        return cnt;
+    }
+
+    /**
+     * @brief 阻塞等待一条数据到期，simulated模式下由advance()推进时钟后唤醒
+     *
+     * @param item: 输出数据
+     * @param timeout: 超时时间(ms)，小于0表示一直等待
+     * @return true: 读取成功
+     * @return false: 等待超时
+     */
+    bool pop(T &item, int64_t timeout = -1)
+    {
+        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            int64_t wait = -1; // 小于0表示一直等待写入或时钟推进的通知(队列为空或simulated模式)
+            if (!m_heap.empty()) {
+                int64_t remain = m_heap.front().deadline - now();
+                if (remain <= 0) {
+                    item = popFront();
+                    return true;
+                }
+                if (!isSimulated()) {
+                    wait = remain;
+                }
+            }
+            if (timeout >= 0) {
+                auto left =
+                    std::chrono::duration_cast<std::chrono::milliseconds>(end - std::chrono::steady_clock::now()).count();
+                if (left <= 0) {
+                    return false;
+                }
+                wait = wait < 0 ? left : std::min(wait, left);
+            }
+            if (wait < 0) {
+                m_cv.wait(lock);
+            }
+            else {
+                m_cv.wait_for(lock, std::chrono::milliseconds(std::max<int64_t>(wait, 1)));
+            }
+        }
+    }
+
+    /**
+     * @brief 队列中的数据数量(含未到期)
+     *
+     * @return size_t
+     */
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_heap.size();
+    }
+
+    /**
+     * @brief 当前时间戳(ms)
+     *
+     * @return int64_t
+     */
+    int64_t now() const { return m_service ? m_service->now() : systemNow(); }
+
+private:
+    /**
+     * @brief 是否使用simulated模式的时钟，此时到期与真实时间无关
+     *
+     */
+    bool isSimulated() const { return m_service && ClockMode::simulated == m_service->clockMode(); }
+
+    struct Entry {
+        int64_t deadline; // 到期时间戳
+        uint64_t seq;     // 写入序号，到期时间相同时保证先进先出
+        T item;           // 数据
+    };
+
+    struct Later {
+        bool operator()(const Entry &lhs, const Entry &rhs) const
+        {
+            return lhs.deadline != rhs.deadline ? lhs.deadline > rhs.deadline : lhs.seq > rhs.seq;
+        }
+    };
+
+    /**
+     * @brief 取出最早到期的数据，调用者需持有m_mutex
+     *
+     * @return T
+     */
+    T popFront()
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), Later{});
+        T item = std::move(m_heap.back().item);
+        m_heap.pop_back();
+        return item;
+    }
+
+private:
+    std::shared_ptr<TimerService> m_service; // 提供时钟的定时器服务
+    mutable std::mutex m_mutex;              // 互斥锁
+    std::condition_variable m_cv;            // 数据写入及模拟时钟推进通知
+    std::vector<Entry> m_heap;               // 按到期时间排列的最小堆
+    uint64_t m_seq{0};                       // 递增的写入序号
+    uint32_t m_listener{0};                  // 在定时器服务中注册的时钟推进通知ID
+};
+}; // namespace vcTimer
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file executor.h
+ * @author vc (VchaseNi@gmail.com)
+ * @brief 隔离执行器，在单独的线程中执行被看门狗隔离的慢任务，避免阻塞定时器线程
+ *        备注：
+ *          1. 线程在第一次投递任务时才创建；
+ *          2. 同一任务上一次执行尚未完成时，新的执行会被丢弃，避免任务堆积；
+ *          3. 所有被隔离的任务共享一个线程依次执行，长期阻塞的任务会使其他被隔离的任务无法执行(执行被丢弃)，
+ *             因此隔离仅用于保护定时器线程，任务本身仍不应阻塞；
+ *          4. 任务所有者注销时通过cancel()丢弃其待执行的任务并等待其正在执行的任务结束；
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __VC_EXECUTOR__
+#define __VC_EXECUTOR__
+#include "task.h"
+#include "trace.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+namespace vcTimer {
+
+class Executor {
+public:
+    /**
+     * @brief Construct a new Executor object
+     *
+     * @param ring: 事件追踪缓冲区，为空时不记录
+     */
+    explicit Executor(const std::atomic<TraceRing *> &ring) : m_ring(ring) {}
+
+    ~Executor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_active = false;
+        }
+        m_cv.notify_all();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    /**
+     * @brief 投递任务
+     *
+     * @param owner: 任务所有者
+     * @param id: task id
+     * @param task: 任务对象
+     * @return true: 投递成功
+     * @return false: 该任务上一次执行尚未完成，本次被丢弃
+     */
+    bool post(uint32_t owner, uint32_t id, std::shared_ptr<TaskBase> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_pending.insert(task.get()).second) {
+                return false;
+            }
+            m_queue.push_back(Job{owner, id, std::move(task), nullptr});
+            if (!m_thread.joinable()) {
+                m_thread = std::thread([this]() { run(); });
+            }
+        }
+        m_cv.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 投递收尾操作，在此前投递的任务(包括正在执行的任务)执行结束后，在执行线程中调用
+     *
+     * @param owner: 任务所有者
+     * @param id: task id
+     * @param done: 收尾操作
+     */
+    void defer(uint32_t owner, uint32_t id, std::function<void()> done)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(Job{owner, id, nullptr, std::move(done)});
+            if (!m_thread.joinable()) {
+                m_thread = std::thread([this]() { run(); });
+            }
+        }
+        m_cv.notify_one();
+    }
+
+    /**
+     * @brief 丢弃任务所有者待执行的任务，并等待其正在执行的任务结束；禁止在任务中调用
+     *
+     * @param owner: 任务所有者
+     */
+    void cancel(uint32_t owner)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (auto it = m_queue.begin(); it != m_queue.end();) {
+            if (it->owner == owner) {
+                if (it->task) {
+                    m_pending.erase(it->task.get());
+                }
+                it = m_queue.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        m_doneCv.wait(lock, [this, owner]() { return m_running != owner; });
+    }
+
+private:
+    struct Job {
+        uint32_t owner;                 // 任务所有者
+        uint32_t id;                    // task id
+        std::shared_ptr<TaskBase> task; // 任务对象，为空时仅执行收尾操作
+        std::function<void()> done;     // 收尾操作
+    };
+
+    /**
+     * @brief 执行线程
+     *
+     */
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cv.wait(lock, [this]() { return !m_active || !m_queue.empty(); });
+            if (!m_active) {
+                break;
+            }
+            auto job = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_running = job.owner;
+            lock.unlock();
+            if (job.task) {
+                trace(TraceType::taskFire, job.id);
+                job.task->execute();
+                trace(TraceType::callbackEnd, job.id);
+            }
+            if (job.done) {
+                job.done();
+            }
+            lock.lock();
+            m_pending.erase(job.task.get());
+            m_running = 0;
+            m_doneCv.notify_all();
+        }
+    }
+
+    void trace(TraceType type, uint32_t id)
+    {
+        if (auto *ring = m_ring.load(std::memory_order_acquire)) {
+            ring->record(type, id);
+        }
+    }
+
+private:
+    bool m_active{true};                            // 执行器是否处于活动状态
+    std::mutex m_mutex;                             // 互斥锁
+    std::condition_variable m_cv;                   // 任务通知
+    std::condition_variable m_doneCv;               // 任务执行结束通知
+    std::deque<Job> m_queue;                        // 待执行任务
+    std::unordered_set<const TaskBase *> m_pending; // 待执行或执行中的任务
+    uint32_t m_running{0};                          // 正在执行的任务的所有者，0表示空闲
+    std::thread m_thread;                           // 执行线程
+    const std::atomic<TraceRing *> &m_ring;         // 事件追踪缓冲区
+};
+}; // namespace vcTimer
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file deadline.cpp
+ * @author vc (VchaseNi@gmail.com)
+ * @brief 对比按任务列表(map)逐个判断到期与DeadlineStore连续数组扫描的耗时，任务数100~100k，每次tick约1%任务到期
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <chrono>
+#include <iostream>
+#include <random>
+#include "timer.h"
+
+using namespace vcTimer;
+
+const int64_t Ticks = 1000;
+const int64_t Interval = 100; // 每个tick前进1ms，任务间隔100ms，约1%任务到期
+
+template <typename F>
+double measure(F &&f)
+{
+    auto begin = std::chrono::steady_clock::now();
+    for (int64_t tick = 1; tick <= Ticks; tick++) {
+        f(tick);
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / Ticks;
+}
+
+int main()
+{
+    std::mt19937 rng(1);
+    for (uint32_t cnt : {100u, 1000u, 10000u, 100000u}) {
+        std::map<TaskId, TaskInfo> taskMap;
+        DeadlineStore store;
+        std::vector<int64_t> initial(cnt + 1); // 初始截止时间
+        for (uint32_t id = 1; id <= cnt; id++) {
+            int64_t last = -static_cast<int64_t>(rng() % Interval);
+            initial[id] = last + Interval;
+            taskMap.emplace(id, TaskInfo{TaskMode::period, Interval, 0, last, 0, 0, TaskStatus::running, nullptr,
+                                         nullptr, store.add(id)});
+            store.update(taskMap[id].slot, last + Interval);
+        }
+
+        size_t mapDue = 0;
+        double mapNs = measure([&](int64_t curStamp) {
+            for (auto &[id, info] : taskMap) {
+                if (info.status == TaskStatus::running && curStamp - info.lastExecuteTime >= info.interval) {
+                    info.lastExecuteTime = curStamp;
+                    mapDue++;
+                }
+            }
+        });
+
+        size_t storeDue = 0;
+        std::vector<uint32_t> due;
+        double storeNs = measure([&](int64_t curStamp) {
+            store.collectDue(curStamp, due);
+            for (auto id : due) {
+                auto &info = taskMap.find(id)->second;
+                store.update(info.slot, curStamp + Interval);
+            }
+            storeDue += due.size();
+        });
+
+        // 仅测量collectDue()：到期任务通过槽位直接更新，不查找任务列表
+        DeadlineStore kernel;
+        std::vector<uint32_t> slots(cnt + 1);
+        for (uint32_t id = 1; id <= cnt; id++) {
+            slots[id] = kernel.add(id);
+            kernel.update(slots[id], initial[id]);
+        }
+        double kernelNs = measure([&](int64_t curStamp) {
+            kernel.collectDue(curStamp, due);
+            for (auto id : due) {
+                kernel.update(slots[id], curStamp + Interval);
+            }
+        });
+
+        std::cout << "tasks: " << cnt << " map scan: " << mapNs << " ns/tick (" << mapDue << " due)"
+                  << " deadline store: " << storeNs << " ns/tick (" << storeDue << " due)"
+                  << " collectDue: " << kernelNs << " ns/tick" << std::endl;
+    }
+}
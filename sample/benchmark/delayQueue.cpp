@@ -0,0 +1,74 @@
+/**
+ * @file delayQueue.cpp
+ * @author vc (VchaseNi@gmail.com)
+ * @brief 对比DelayQueue与为每条数据添加单次任务(addTask)的吞吐量，使用simulated模式的定时器服务避免真实等待；
+ *        每次control()都会遍历任务列表重新计算最大公约数，addTask方式为O(n^2)，仅对比到AddTaskMax条数据
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <chrono>
+#include <iostream>
+#include "delayQueue.h"
+#include "timer.h"
+
+using namespace vcTimer;
+
+struct Retry {
+    uint64_t msgId;
+    uint32_t attempt;
+};
+
+const int64_t Delay = 250;
+const uint64_t AddTaskMax = 10000;
+
+template <typename F>
+double measure(F &&f)
+{
+    auto begin = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main()
+{
+    for (uint64_t cnt : {1000u, 10000u, 100000u, 1000000u}) {
+        size_t queueCnt = 0;
+        double queueMs = measure([&]() {
+            auto service = std::make_shared<TimerService>(ClockMode::simulated);
+            DelayQueue<Retry> queue(service);
+            for (uint64_t i = 0; i < cnt; i++) {
+                queue.push(Retry{i, 1}, Delay + static_cast<int64_t>(i % 100));
+            }
+            service->advance(TimerSecond);
+            std::vector<Retry> out;
+            out.reserve(cnt);
+            queueCnt = queue.popReady(out);
+        });
+
+        std::cout << "items: " << cnt << " DelayQueue: " << queueMs << " ms (" << queueCnt << " ready)";
+        if (cnt > AddTaskMax) {
+            std::cout << std::endl;
+            continue;
+        }
+
+        size_t taskCnt = 0;
+        double taskMs = measure([&]() {
+            Timer tm(ClockMode::simulated);
+            std::vector<Retry> out;
+            out.reserve(cnt);
+            for (uint64_t i = 0; i < cnt; i++) {
+                auto [id, _] = tm.addTask<TaskMode::single>(Delay + static_cast<int64_t>(i % 100), 0,
+                                                            [&out](Retry retry) { out.push_back(retry); },
+                                                            Retry{i, 1});
+                tm.control(id, TaskControl::start);
+            }
+            tm.advance(TimerSecond);
+            taskCnt = out.size();
+        });
+
+        std::cout << " addTask: " << taskMs << " ms (" << taskCnt << " fired)" << std::endl;
+    }
+}
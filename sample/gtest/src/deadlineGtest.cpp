@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "deadline.h"
+
+using namespace vcTimer;
+TEST(deadline, collectDue)
+{
+    DeadlineStore store;
+    std::vector<uint32_t> due;
+    for (uint32_t key = 1; key <= 37; key++) {
+        auto slot = store.add(key);
+        store.update(slot, key * 10);
+    }
+    store.collectDue(5, due);
+    ASSERT_TRUE(due.empty());
+
+    store.collectDue(100, due);
+    std::sort(due.begin(), due.end());
+    ASSERT_EQ(due.size(), 10);
+    ASSERT_EQ(due.front(), 1);
+    ASSERT_EQ(due.back(), 10);
+
+    // 到期任务由调用者更新截止时间，下界为未到期任务中最小的截止时间
+    store.collectDue(105, due);
+    ASSERT_TRUE(due.empty());
+    store.collectDue(110, due);
+    ASSERT_EQ(due.size(), 11);
+
+    store.collectDue(DeadlineNever - 1, due);
+    ASSERT_EQ(due.size(), 37);
+}
+
+TEST(deadline, remove)
+{
+    DeadlineStore store;
+    std::vector<uint32_t> due;
+    store.add(1);
+    auto slot = store.add(2);
+    store.update(store.add(3), 0);
+    store.update(slot, 0);
+
+    ASSERT_EQ(store.remove(slot), 3); // 最后一个任务移动到被移除的槽位
+    ASSERT_EQ(store.remove(slot), 0);
+    ASSERT_EQ(store.size(), 1);
+    store.collectDue(0, due);
+    ASSERT_TRUE(due.empty()); // 未运行的任务不会到期
+}
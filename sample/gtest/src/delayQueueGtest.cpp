@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include "delayQueue.h"
+
+using namespace vcTimer;
+TEST(delayQueue, order)
+{
+    auto service = std::make_shared<TimerService>(ClockMode::simulated);
+    DelayQueue<std::string> queue(service);
+    queue.push("c", 300);
+    queue.push("a", 100);
+    queue.emplace(100, 1, 'b'); // 到期时间相同时先进先出
+    queue.push("d", 400);
+
+    std::vector<std::string> out;
+    ASSERT_EQ(queue.popReady(out), 0);
+    service->advance(300);
+    ASSERT_EQ(queue.popReady(out, 2), 2);
+    ASSERT_EQ(queue.popReady(out), 1);
+    ASSERT_EQ(out, (std::vector<std::string>{"a", "b", "c"}));
+    ASSERT_EQ(queue.size(), 1);
+}
+
+TEST(delayQueue, pop)
+{
+    DelayQueue<int> queue;
+    int item = 0;
+    ASSERT_FALSE(queue.pop(item, 10));
+
+    auto begin = std::chrono::steady_clock::now();
+    queue.push(2, 100);
+    std::thread producer([&]() { queue.push(1, 50); });
+    ASSERT_TRUE(queue.pop(item));
+    ASSERT_EQ(item, 1);
+    ASSERT_TRUE(queue.pop(item, TimerSecond));
+    ASSERT_EQ(item, 2);
+    auto cost = std::chrono::duration_cast<TimerUnit>(std::chrono::steady_clock::now() - begin).count();
+    ASSERT_GE(cost, 99);
+    producer.join();
+}
+
+TEST(delayQueue, simulatedPop)
+{
+    auto service = std::make_shared<TimerService>(ClockMode::simulated);
+    DelayQueue<int> queue(service);
+    queue.push(1, 500);
+    int item = 0;
+    ASSERT_FALSE(queue.pop(item, 10)); // 模拟时钟未推进，超时为真实时间
+
+    std::thread driver([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        service->advance(500);
+    });
+    ASSERT_TRUE(queue.pop(item)); // advance()推进时钟后唤醒
+    ASSERT_EQ(item, 1);
+    driver.join();
+}
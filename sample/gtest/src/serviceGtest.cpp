@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "timer.h"
+
+using namespace vcTimer;
+TEST(service, shared)
+{
+    auto service = std::make_shared<TimerService>(ClockMode::simulated);
+    uint32_t cnt = 0;
+    uint32_t cnt1 = 0;
+    Timer tm(service);
+    auto [id, _] = tm.addTask<TaskMode::period>(100, 0, [&]() { cnt++; });
+    tm.control(id, TaskControl::start);
+    {
+        Timer tm1(service);
+        auto [id1, _1] = tm1.addTask<TaskMode::span>(100, 1000, [&]() { cnt1++; });
+        tm1.control(id1, TaskControl::start);
+        tm1.control(id, TaskControl::stop); // 不能控制其他Timer的任务
+        ASSERT_EQ(tm.taskCount(), 1);
+        ASSERT_EQ(tm1.taskCount(), 1);
+        ASSERT_EQ(service->taskCount(), 2);
+
+        tm.advance(500);
+        ASSERT_EQ(cnt, 5);
+        ASSERT_EQ(cnt1, 5);
+    }
+    ASSERT_EQ(service->taskCount(), 1); // Timer析构时停止其所有任务
+
+    tm.advance(500);
+    ASSERT_EQ(cnt, 10);
+    ASSERT_EQ(cnt1, 5);
+}
+
+TEST(service, waitUntilEmpty)
+{
+    Timer tm(TimerService::instance());
+    Timer tm1(TimerService::instance());
+    auto [id, _] = tm.addTask<TaskMode::single>(100, 100, []() {});
+    tm.control(id, TaskControl::start);
+    auto [id1, _1] = tm1.addTask<TaskMode::period>(100, 0, []() {});
+    tm1.control(id1, TaskControl::start);
+
+    ASSERT_TRUE(tm.waitUntilEmpty(5 * TimerSecond)); // 仅等待本Timer的任务
+    ASSERT_FALSE(tm1.isTaskEmpty());
+    ASSERT_EQ(tm.service(), tm1.service());
+}
+
+static uint32_t g_batchCallCnt = 0;
+static void countBatch(const int *, size_t) { g_batchCallCnt++; }
+
+TEST(service, batchPerOwner)
+{
+    auto service = std::make_shared<TimerService>(ClockMode::simulated);
+    Timer tm(service);
+    auto id = tm.addBatchTask<TaskMode::period>(100, 0, countBatch, 1);
+    tm.control(id, TaskControl::start);
+    {
+        Timer tm1(service);
+        auto id1 = tm1.addBatchTask<TaskMode::period>(100, 0, countBatch, 2);
+        tm1.control(id1, TaskControl::start);
+
+        g_batchCallCnt = 0;
+        service->advance(100);
+        ASSERT_EQ(g_batchCallCnt, 2); // 不同Timer的任务不合并到同一次回调
+    }
+    g_batchCallCnt = 0;
+    service->advance(100);
+    ASSERT_EQ(g_batchCallCnt, 1);
+}
+
+TEST(service, detachWaitsFinished)
+{
+    std::atomic<bool> isRunning{false};
+    std::atomic<bool> isDone{false};
+    {
+        Timer tm(TimerService::instance());
+        auto [id, _] = tm.addTask<TaskMode::single>(10, 0, []() {});
+        tm.onFinished(id, [&](TaskId) {
+            isRunning = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            isDone = true;
+        });
+        tm.control(id, TaskControl::start);
+        while (!isRunning) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    ASSERT_TRUE(isDone); // Timer析构时等待正在执行的完成回调结束
+}
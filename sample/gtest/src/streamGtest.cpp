@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "timer.h"
+
+using namespace vcTimer;
+TEST(stream, overflow)
+{
+    ResultStream<int> oldest(4, OverflowPolicy::dropOldest);
+    ResultStream<int> newest(3, OverflowPolicy::dropNewest);
+    ASSERT_EQ(newest.capacity(), 4);
+    for (int i = 0; i < 10; i++) {
+        oldest.push(i);
+        newest.push(i);
+    }
+    ASSERT_EQ(oldest.dropped(), 6);
+    ASSERT_EQ(newest.dropped(), 6);
+
+    std::vector<int> out;
+    ASSERT_EQ(oldest.popBatch(out, 3), 3);
+    ASSERT_EQ(oldest.popBatch(out), 1);
+    ASSERT_EQ(out, (std::vector<int>{6, 7, 8, 9}));
+
+    out.clear();
+    ASSERT_EQ(newest.popBatch(out), 4);
+    ASSERT_EQ(out, (std::vector<int>{0, 1, 2, 3}));
+    int value = 0;
+    ASSERT_FALSE(newest.tryPop(value));
+}
+
+struct Sample {
+    explicit Sample(int v) : value(v) {}
+    int value;
+};
+
+TEST(stream, noDefaultConstruct)
+{
+    ResultStream<Sample> stream(2, OverflowPolicy::dropOldest);
+    for (int i = 0; i < 3; i++) {
+        stream.push(Sample{i});
+    }
+    ASSERT_EQ(stream.dropped(), 1);
+    std::vector<Sample> out;
+    ASSERT_EQ(stream.popBatch(out), 2);
+    ASSERT_EQ(out.front().value, 1);
+    ASSERT_EQ(out.back().value, 2);
+
+    ResultStream<std::unique_ptr<int>> ptrs(2, OverflowPolicy::dropNewest);
+    ptrs.push(std::make_unique<int>(7));
+    std::unique_ptr<int> ptr;
+    ASSERT_TRUE(ptrs.tryPop(ptr));
+    ASSERT_EQ(*ptr, 7);
+}
+
+TEST(stream, concurrent)
+{
+    ResultStream<uint64_t> stream(64, OverflowPolicy::dropNewest);
+    const uint64_t cnt = 10000;
+    std::thread producer([&]() {
+        for (uint64_t i = 1; i <= cnt; i++) {
+            while (!stream.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 1;
+    std::vector<uint64_t> out;
+    while (expected <= cnt) {
+        out.clear();
+        if (stream.popBatch(out, 16) == 0) {
+            std::this_thread::yield();
+        }
+        for (auto value : out) {
+            ASSERT_EQ(value, expected++);
+        }
+    }
+    producer.join();
+}
+
+TEST(stream, timer)
+{
+    Timer tm(ClockMode::simulated);
+    int cnt = 0;
+    auto [id, stream] = tm.addStreamTask<TaskMode::span>(100, 1000, 4, OverflowPolicy::dropOldest, [&]() {
+        return ++cnt;
+    });
+    tm.control(id, TaskControl::start);
+
+    tm.advance(200);
+    std::vector<int> out;
+    ASSERT_EQ(stream->popBatch(out), 2);
+    ASSERT_EQ(out, (std::vector<int>{1, 2}));
+
+    tm.advance(TimerSecond);
+    ASSERT_TRUE(tm.isTaskEmpty());
+    out.clear();
+    stream->popBatch(out);
+    ASSERT_EQ(out, (std::vector<int>{7, 8, 9, 10}));
+    ASSERT_EQ(stream->dropped(), 4);
+}
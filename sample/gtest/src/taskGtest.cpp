@@ -70,4 +70,59 @@ TEST(task, functor)
     task->execute();
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
     ASSERT_EQ(functor.functorCnt, 1);
-}
\ No newline at end of file
+}
+
+struct CopyCounter {
+    static uint32_t copyCnt;
+    CopyCounter() = default;
+    CopyCounter(const CopyCounter &) { copyCnt++; }
+    CopyCounter(CopyCounter &&) = default;
+};
+uint32_t CopyCounter::copyCnt = 0;
+
+static void byValue(CopyCounter) {}
+static void byCref(const CopyCounter &) {}
+
+TEST(task, argPolicy)
+{
+    static_assert(isCopiedPerFire_v<decltype(&byValue)>);
+    static_assert(!isCopiedPerFire_v<decltype(&byCref)>);
+    static_assert(!isCopiedPerFire_v<decltype(&print_hello)>);
+    static_assert(isCopiedPerFire_v<decltype(&print_message_param)>);
+    static_assert(!isCopiedPerFire_v<decltype(&MyClass::member_func)>);
+
+    // copy: 按值接收的参数每次执行都会拷贝
+    auto [task, _] = makeTask<TaskMode::period>(byValue, CopyCounter{});
+    CopyCounter::copyCnt = 0;
+    task->execute();
+    task->execute();
+    ASSERT_EQ(CopyCounter::copyCnt, 2);
+
+    // cref: 周期执行不拷贝参数
+    auto [task1, _1] = makeTask<TaskMode::period, ArgPolicy::cref>(byCref, CopyCounter{});
+    CopyCounter::copyCnt = 0;
+    task1->execute();
+    task1->execute();
+    ASSERT_EQ(CopyCounter::copyCnt, 0);
+
+    // move: 单次任务的参数移动到可调用对象
+    auto [task2, fut] = makeTask<TaskMode::singleFuture, ArgPolicy::move>(byValue, CopyCounter{});
+    CopyCounter::copyCnt = 0;
+    task2->execute();
+    ASSERT_EQ(CopyCounter::copyCnt, 0);
+}
+
+TEST(task, moveOnlyArg)
+{
+    // move: 仅可移动的参数也可用于single模式
+    int value = 0;
+    auto [task, _] = makeTask<TaskMode::single, ArgPolicy::move>(
+        [&value](std::unique_ptr<int> ptr) { value = *ptr; }, std::make_unique<int>(5));
+    task->execute();
+    ASSERT_EQ(value, 5);
+
+    auto [task1, fut] = makeTask<TaskMode::singleFuture, ArgPolicy::move>(
+        [](std::unique_ptr<int> ptr) { return *ptr; }, std::make_unique<int>(6));
+    task1->execute();
+    ASSERT_EQ(fut.get(), 6);
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <gtest/gtest.h>
+#include <sstream>
 #include "callable.h"
 #include "timer.h"
 
@@ -172,3 +173,273 @@ TEST(timer, mixed)
         }
     }
 }
+
+TEST(timer, waitUntilEmpty)
+{
+    Timer tm;
+    std::atomic<uint32_t> finishedCnt{0};
+    std::atomic<TaskId> finishedId{0};
+    auto [id, _] = tm.addTask<TaskMode::span>(100, 300, [&]() { std::cout << "Span called!" << std::endl; });
+    tm.onFinished(id, [&](TaskId fid) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20)); // waitUntilEmpty()需等待完成回调执行结束
+        finishedCnt++;
+        finishedId = fid;
+    });
+    tm.control(id, TaskControl::start);
+    ASSERT_EQ(tm.taskCount(), 1);
+    ASSERT_FALSE(tm.waitUntilEmpty(10));
+
+    ASSERT_TRUE(tm.waitUntilEmpty(5 * TimerSecond));
+    ASSERT_TRUE(tm.isTaskEmpty());
+    ASSERT_EQ(finishedCnt, 1);
+    ASSERT_EQ(finishedId, id);
+}
+
+TEST(timer, onFinishedStop)
+{
+    Timer tm;
+    uint32_t finishedCnt = 0;
+    auto [id, _] = tm.addTask<TaskMode::period>(100, 0, []() {});
+    tm.onFinished(id, [&](TaskId) { finishedCnt++; });
+    tm.control(id, TaskControl::start);
+    tm.control(id, TaskControl::stop);
+    ASSERT_TRUE(tm.waitUntilEmpty(0));
+    ASSERT_EQ(finishedCnt, 0);
+}
+
+TEST(timer, simulatedSpan)
+{
+    Timer tm(ClockMode::simulated);
+    g_normalParamFuncCnt = 0;
+    auto [id, _] = tm.addTask<TaskMode::span>(500, 2 * TimerSecond, print_message_param, "hello", 1);
+    tm.control(id, TaskControl::start);
+
+    tm.advance(5 * TimerSecond);
+    ASSERT_TRUE(tm.isTaskEmpty());
+    ASSERT_EQ(g_normalParamFuncCnt, 4);
+    ASSERT_EQ(tm.now(), SimulatedEpoch + 5 * TimerSecond);
+}
+
+TEST(timer, simulatedWaitUntilEmpty)
+{
+    Timer tm(ClockMode::simulated);
+    auto [id, _] = tm.addTask<TaskMode::single>(500, 0, []() {});
+    tm.control(id, TaskControl::start);
+    ASSERT_FALSE(tm.waitUntilEmpty(0)); // 模拟时钟不会自行推进
+
+    std::thread driver([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        tm.advance(TimerSecond);
+    });
+    ASSERT_TRUE(tm.waitUntilEmpty(5 * TimerSecond)); // 由其他线程驱动advance()
+    driver.join();
+
+    tm.advance(-TimerSecond); // 模拟时钟不能倒退
+    ASSERT_EQ(tm.now(), SimulatedEpoch + TimerSecond);
+}
+
+TEST(timer, simulatedMixed)
+{
+    Timer tm(ClockMode::simulated);
+    MyClass::staticFuncCnt = 0;
+    auto [id, _] = tm.addTask<TaskMode::span>(500, 2 * TimerSecond, &MyClass::static_func);
+    tm.control(id, TaskControl::start);
+
+    auto [id1, future] = tm.addTask<TaskMode::span>(800, 2 * TimerSecond, &MyClass::static_func);
+    tm.control(id1, TaskControl::start);
+
+    tm.advance(4 * TimerSecond);
+    ASSERT_TRUE(tm.isTaskEmpty());
+    ASSERT_EQ(MyClass::staticFuncCnt, 6);
+
+    // 回放1小时的100ms周期任务，任务列表为空时tick间隔为TimerGcd，首次执行需等待下一次tick
+    uint32_t periodCnt = 0;
+    auto [id2, fut] = tm.addTask<TaskMode::period>(100, 0, [&]() { periodCnt++; });
+    tm.control(id2, TaskControl::start);
+    tm.advance(3600 * TimerSecond);
+    ASSERT_EQ(periodCnt, 35991);
+}
+
+struct BatchArg {
+    uint32_t signal;
+    uint32_t weight;
+};
+static uint32_t g_batchCallCnt = 0;
+static uint32_t g_batchArgCnt = 0;
+static uint32_t g_batchWeight = 0;
+
+static void batchFunc(const BatchArg *args, size_t cnt)
+{
+    g_batchCallCnt++;
+    g_batchArgCnt += cnt;
+    for (size_t i = 0; i < cnt; i++) {
+        g_batchWeight += args[i].weight;
+    }
+}
+
+TEST(timer, batch)
+{
+    Timer tm(ClockMode::simulated);
+    for (uint32_t i = 0; i < 100; i++) {
+        auto id = tm.addBatchTask<TaskMode::period>(100, 0, batchFunc, BatchArg{i, 1});
+        tm.control(id, TaskControl::start);
+    }
+    auto id = tm.addBatchTask<TaskMode::single>(100, 100, batchFunc, BatchArg{100, 10});
+    tm.control(id, TaskControl::start);
+
+    tm.advance(100);
+    ASSERT_EQ(g_batchCallCnt, 1);
+    ASSERT_EQ(g_batchArgCnt, 101);
+    ASSERT_EQ(g_batchWeight, 110);
+
+    tm.advance(500);
+    ASSERT_EQ(g_batchCallCnt, 6);
+    ASSERT_EQ(g_batchArgCnt, 601);
+    ASSERT_EQ(tm.taskCount(), 100);
+}
+
+TEST(timer, batchRelease)
+{
+    Timer tm(ClockMode::simulated);
+    g_batchCallCnt = 0;
+    g_batchArgCnt = 0;
+    for (uint32_t round = 0; round < 2; round++) {
+        // 组内最后一个任务在tick中完成，组在回调后释放，再次添加时重新创建
+        auto id = tm.addBatchTask<TaskMode::single>(100, 100, batchFunc, BatchArg{round, 1});
+        tm.control(id, TaskControl::start);
+        auto id1 = tm.addBatchTask<TaskMode::period>(100, 0, batchFunc, BatchArg{round, 1});
+        tm.control(id1, TaskControl::start);
+        tm.advance(100);
+        tm.control(id1, TaskControl::stop);
+    }
+    ASSERT_EQ(g_batchCallCnt, 2);
+    ASSERT_EQ(g_batchArgCnt, 4);
+    ASSERT_TRUE(tm.isTaskEmpty());
+}
+
+TEST(timer, watchdog)
+{
+    Timer tm(ClockMode::simulated);
+    std::atomic<uint32_t> slowCnt{0};
+    std::thread::id fireThread;
+    auto [id, _] = tm.addTask<TaskMode::period>(100, 0, [&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        fireThread = std::this_thread::get_id();
+        slowCnt++;
+    });
+    tm.setBudget(id, 1000);
+    uint32_t hookCnt = 0;
+    bool isIsolated = false;
+    tm.service()->setWatchdog(3, [&](TaskId, int64_t cost, bool isolated) {
+        hookCnt++;
+        isIsolated = isolated;
+        ASSERT_GT(cost, 1000);
+    });
+    tm.control(id, TaskControl::start);
+
+    tm.advance(300);
+    ASSERT_EQ(slowCnt, 3);
+    ASSERT_EQ(hookCnt, 3);
+    ASSERT_TRUE(isIsolated);
+    ASSERT_EQ(fireThread, std::this_thread::get_id());
+
+    // 隔离后在隔离执行器中执行
+    tm.advance(100);
+    for (uint32_t i = 0; i < 100 && slowCnt != 4; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(slowCnt, 4);
+    ASSERT_NE(fireThread, std::this_thread::get_id());
+
+    auto stats = tm.service()->watchdogStats();
+    ASSERT_EQ(stats.overBudgetCnt, 3);
+    ASSERT_EQ(stats.isolatedCnt, 1);
+    ASSERT_EQ(stats.isolatedFire, 1);
+}
+
+TEST(timer, watchdogDefaultBudget)
+{
+    Timer tm(ClockMode::simulated);
+    uint32_t hookCnt = 0;
+    TaskId hookId = 0;
+    tm.service()->setWatchdog(
+        3,
+        [&](TaskId id, int64_t, bool) {
+            hookCnt++;
+            hookId = id;
+        },
+        1000);
+    auto slow = [&]() { std::this_thread::sleep_for(std::chrono::milliseconds(5)); };
+    auto [id1, _1] = tm.addTask<TaskMode::period>(100, 0, slow); // 继承默认预算
+    auto [id2, _2] = tm.addTask<TaskMode::period>(100, 0, slow);
+    tm.setBudget(id2, 0); // 关闭检测
+    tm.control(id1, TaskControl::start);
+    tm.control(id2, TaskControl::start);
+
+    tm.advance(200);
+    ASSERT_EQ(hookCnt, 2);
+    ASSERT_EQ(hookId, id1);
+    ASSERT_EQ(tm.service()->watchdogStats().overBudgetCnt, 2);
+}
+
+TEST(timer, watchdogFinish)
+{
+    auto service = std::make_shared<TimerService>(ClockMode::simulated);
+    service->setWatchdog(1, [](TaskId, int64_t, bool) {});
+    Timer tm(service);
+    std::atomic<bool> isRunning{false};
+    std::atomic<bool> isOrdered{false};
+    std::atomic<uint32_t> finCnt{0};
+    auto [id, _] = tm.addTask<TaskMode::span>(100, 200, [&]() {
+        isRunning = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        isRunning = false;
+    });
+    tm.setBudget(id, 1000);
+    tm.onFinished(id, [&](TaskId) {
+        isOrdered = !isRunning;
+        finCnt++;
+    });
+    tm.control(id, TaskControl::start);
+    tm.advance(300); // 第一次执行后被隔离，最后一次执行投递到隔离执行器
+    ASSERT_FALSE(tm.isTaskEmpty()); // 最后一次执行未结束，任务数量未减少
+    ASSERT_TRUE(tm.waitUntilEmpty(1000));
+    ASSERT_EQ(finCnt, 1);
+    ASSERT_TRUE(isOrdered); // 完成回调在最后一次执行结束后调用
+}
+
+TEST(timer, watchdogDetach)
+{
+    auto service = std::make_shared<TimerService>(ClockMode::simulated);
+    service->enableTrace(1024);
+    service->setWatchdog(1, [](TaskId, int64_t, bool) {});
+    std::atomic<uint32_t> slowCnt{0};
+    std::atomic<bool> isDone{false};
+    TaskId id = 0;
+    {
+        Timer tm(service);
+        std::tie(id, std::ignore) = tm.addTask<TaskMode::period>(100, 0, [&]() {
+            slowCnt++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(slowCnt == 1 ? 5 : 50));
+            isDone = slowCnt > 1;
+        });
+        tm.setBudget(id, 1000);
+        tm.control(id, TaskControl::start);
+        tm.advance(200); // 第一次执行后被隔离，第二次投递到隔离执行器
+        for (uint32_t i = 0; i < 100 && slowCnt != 2; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        ASSERT_EQ(slowCnt, 2);
+    }
+    ASSERT_TRUE(isDone); // Timer析构时等待被隔离的任务执行结束
+
+    std::stringstream ss;
+    service->dumpTrace(ss);
+    std::vector<TraceEvent> events;
+    ASSERT_TRUE(readTrace(ss, events));
+    uint32_t isolatedFireCnt = 0;
+    for (const auto &event : events) {
+        isolatedFireCnt += event.type == TraceType::taskFire && event.id == id && event.tid != traceThreadId();
+    }
+    ASSERT_EQ(isolatedFireCnt, 1); // 隔离执行器线程记录的执行事件
+}
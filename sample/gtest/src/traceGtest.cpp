@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "timer.h"
+
+using namespace vcTimer;
+TEST(trace, ring)
+{
+    TraceRing ring(3);
+    ASSERT_EQ(ring.capacity(), 4);
+    for (uint32_t id = 1; id <= 6; id++) {
+        ring.record(TraceType::taskAdd, id);
+    }
+    auto events = ring.snapshot(); // 写满后覆盖最旧的事件
+    ASSERT_EQ(events.size(), 4);
+    ASSERT_EQ(events.front().id, 3);
+    ASSERT_EQ(events.back().id, 6);
+    ASSERT_EQ(events.back().type, TraceType::taskAdd);
+    ASSERT_EQ(events.back().tid, traceThreadId());
+}
+
+TEST(trace, dump)
+{
+    Timer tm(ClockMode::simulated);
+    tm.enableTrace(1024);
+    auto [id, _] = tm.addTask<TaskMode::span>(100, 200, []() {});
+    tm.control(id, TaskControl::start);
+    tm.advance(300);
+
+    std::stringstream ss;
+    tm.dumpTrace(ss);
+    std::vector<TraceEvent> events;
+    ASSERT_TRUE(readTrace(ss, events));
+
+    uint32_t fireCnt = 0;
+    int32_t lockCnt = 0;
+    for (const auto &event : events) {
+        fireCnt += event.type == TraceType::taskFire && event.id == id;
+        lockCnt += event.type == TraceType::lockAcquire;
+        lockCnt -= event.type == TraceType::lockRelease;
+    }
+    ASSERT_EQ(fireCnt, 2);
+    ASSERT_EQ(lockCnt, 0);
+    ASSERT_EQ(events[0].type, TraceType::lockAcquire);
+    ASSERT_EQ(events[1].type, TraceType::taskAdd);
+
+    std::stringstream json;
+    writeChromeTrace(events, json);
+    ASSERT_NE(json.str().find("\"name\":\"task\",\"ph\":\"B\""), std::string::npos);
+}
+
+TEST(trace, corrupt)
+{
+    std::vector<TraceEvent> events(3);
+    std::stringstream ss;
+    writeTrace(events, ss);
+    auto data = ss.str();
+
+    std::stringstream truncated(data.substr(0, data.size() - 1));
+    ASSERT_FALSE(readTrace(truncated, events));
+
+    uint64_t huge = UINT64_MAX / 2; // 损坏的数量不会导致分配失败
+    data.replace(sizeof(TraceMagic) + sizeof(TraceVersion), sizeof(huge), reinterpret_cast<const char *>(&huge),
+                 sizeof(huge));
+    std::stringstream corrupt(data);
+    ASSERT_FALSE(readTrace(corrupt, events));
+    ASSERT_TRUE(events.empty());
+}
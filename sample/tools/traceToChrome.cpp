@@ -0,0 +1,37 @@
+/**
+ * @file traceToChrome.cpp
+ * @author vc (VchaseNi@gmail.com)
+ * @brief 将Timer::dumpTrace()导出的二进制事件转换为Chrome trace JSON，可在chrome://tracing或Perfetto中查看
+ *        用法：traceToChrome <trace.bin> [trace.json]，不指定输出文件时输出到标准输出
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <fstream>
+#include <iostream>
+#include "trace.h"
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <trace.bin> [trace.json]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream is(argv[1], std::ios::binary);
+    std::vector<vcTimer::TraceEvent> events;
+    if (!vcTimer::readTrace(is, events)) {
+        std::cerr << "Invalid trace file: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    if (argc > 2) {
+        std::ofstream os(argv[2]);
+        vcTimer::writeChromeTrace(events, os);
+    }
+    else {
+        vcTimer::writeChromeTrace(events, std::cout);
+    }
+}
@@ -0,0 +1,35 @@
+/**
+ * @file batch.cpp
+ * @author vc (VchaseNi@gmail.com)
+ * @brief 适用于大量回调相同、仅参数不同的周期任务；eg：按信号采集，同一tick到期的信号一次性批量处理；
+ *        备注：addBatchTask的回调为函数指针void(*)(const Arg *, size_t)，回调相同的任务为一组
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#include <iostream>
+#include "timer.h"
+
+struct Signal {
+    uint32_t id;
+    uint32_t channel;
+};
+
+void collect(const Signal *signals, size_t cnt)
+{
+    std::cout << "Collecting " << cnt << " signals, first: " << signals[0].id << std::endl;
+}
+
+int main()
+{
+    vcTimer::Timer tm;
+    for (uint32_t i = 0; i < 1000; i++) {
+        auto id = tm.addBatchTask<vcTimer::TaskMode::span>(100 * (1 + i % 2), 5000, collect, Signal{i, i % 8});
+        tm.control(id, vcTimer::TaskControl::start);
+    }
+
+    // 在任务队列为空时退出，Timer析构函数会自动停止所有任务
+    tm.waitUntilEmpty();
+}
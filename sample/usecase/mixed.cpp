@@ -27,7 +27,7 @@ void spanFunc(std::string signal) {
     std::cout <<"Span Collecting: " << signal << std::endl;
 }
 
-void periodFunc(std::vector<std::string> signals) {
+void periodFunc(const std::vector<std::string> &signals) {
     for (const auto &signal : signals) {
         std::cout << "Collecting: " << signal << std::endl;
     }
@@ -41,7 +41,7 @@ int main()
 
 
 
-    auto pe = tm.addTask<vcTimer::TaskMode::period>(200, 0, periodFunc, std::vector<std::string>{"x", "y"});
+    auto pe = tm.addTask<vcTimer::TaskMode::period, vcTimer::ArgPolicy::cref>(200, 0, periodFunc, std::vector<std::string>{"x", "y"});
     tm.control(std::get<0>(pe), vcTimer::TaskControl::start);
 
     auto [id, fut] = tm.addTask<vcTimer::TaskMode::singleFuture>(50, 50, onceFunc, 1);
@@ -49,7 +49,5 @@ int main()
     assert(fut.valid());
     assert(fut.get());
     // 在任务队列为空时退出，Timer析构函数会自动停止所有任务
-    while (!tm.isTaskEmpty()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-    }
+    tm.waitUntilEmpty();
 }
\ No newline at end of file
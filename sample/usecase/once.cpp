@@ -36,7 +36,5 @@ int main()
     assert(!std::get<1>(t).get());
 
     // 在任务队列为空时退出，Timer析构函数会自动停止所有任务
-    while (!tm.isTaskEmpty()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-    }
+    tm.waitUntilEmpty();
 }
\ No newline at end of file
@@ -2,7 +2,8 @@
  * @file period.cpp
  * @author vc (VchaseNi@gmail.com)
  * @brief 适用于周期性定时器，周期性执行任务；eg：每隔1s采集一次信号；
- *        备注：addTask的参数(mode = vcTimer::TaskMode::period, span = 0)
+ *        备注：addTask的参数(mode = vcTimer::TaskMode::period, span = 0)；
+ *              ArgPolicy::cref保证周期执行时不拷贝参数，函数按值接收参数时编译报错
  * @version 0.1
  * @date 2025-05-24
  * 
@@ -14,7 +15,7 @@
 #include <vector>
 #include "timer.h"
 
-void collect(std::vector<std::string> signals) {
+void collect(const std::vector<std::string> &signals) {
     for (const auto &signal : signals) {
         std::cout << "Collecting: " << signal << std::endl;
     }
@@ -24,11 +25,9 @@ int main()
 {
     vcTimer::Timer tm;
     std::vector<std::string> signals = {"x", "y"};
-    auto [id, _] = tm.addTask<vcTimer::TaskMode::period>(1000, 0, collect, signals);
+    auto [id, _] = tm.addTask<vcTimer::TaskMode::period, vcTimer::ArgPolicy::cref>(1000, 0, collect, signals);
     tm.control(id, vcTimer::TaskControl::start);
 
     // 在任务队列为空时退出，Timer析构函数会自动停止所有任务
-    while (!tm.isTaskEmpty()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-    }
+    tm.waitUntilEmpty();
 }
\ No newline at end of file
@@ -24,7 +24,5 @@ int main()
     tm.control(id, vcTimer::TaskControl::start);
 
     // 在任务队列为空时退出，Timer析构函数会自动停止所有任务
-    while (!tm.isTaskEmpty()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-    }
+    tm.waitUntilEmpty();
 }
\ No newline at end of file
@@ -0,0 +1,854 @@
+/**
+ * @file service.h
+ * @author vc (VchaseNi@gmail.com)
+ * @brief 定时器服务，运行一个调度线程并管理所有任务；多个Timer可以共享同一个服务，
+ *        各Timer的任务互相隔离，Timer析构时停止其所有任务
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __VC_SERVICE__
+#define __VC_SERVICE__
+#include "deadline.h"
+#include "executor.h"
+#include "task.h"
+#include "trace.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <numeric>
+#include <vector>
+
+namespace vcTimer {
+
+// 任务状态
+enum class TaskStatus {
+    notStarted = 0, // 无状态
+    pausing = 1,    // 暂停
+    running = 2,    // 运行中
+    finished = 3,   // 完成
+};
+
+// 任务控制
+enum class TaskControl {
+    start = 0, // 启动
+    stop = 1,  // 停止
+};
+
+// 时钟模式
+enum class ClockMode {
+    real = 0,      // 系统时钟，由定时器线程驱动
+    simulated = 1, // 模拟时钟，由advance()手动推进，不创建定时器线程
+};
+
+using TaskId = uint32_t;
+using OwnerId = uint32_t;
+using FinishedCallback = std::function<void(TaskId)>;
+using WatchdogHook = std::function<void(TaskId, int64_t, bool)>; // task id, 执行耗时(us), 是否被隔离
+
+// 看门狗统计
+struct WatchdogStats {
+    uint64_t overBudgetCnt; // 超出预算的执行次数
+    uint64_t isolatedCnt;   // 被隔离的任务数
+    uint64_t isolatedFire;  // 在隔离执行器中执行的次数
+    uint64_t skippedFire;   // 隔离任务上一次执行未完成而丢弃的次数
+};
+
+struct TaskInfo {
+    TaskMode mode;                  // 任务模式
+    int64_t interval;               // 间隔时间
+    int64_t span;                   // 周期时间
+    int64_t lastExecuteTime;        // 上次执行时间
+    int64_t firstExecuteTime;       // 第一次执行时间
+    int64_t startTime;              // 启动时间
+    TaskStatus status;              // 任务状态
+    std::shared_ptr<TaskBase> task; // 任务对象，被隔离时与隔离执行器共享
+    FinishedCallback onFinished;    // 任务完成回调
+    uint32_t slot;                  // 在截止时间存储中的槽位
+    OwnerId owner;                  // 所属Timer
+    int64_t budget;                 // 单次执行的时间预算(us)，0表示不检测
+    uint32_t overCnt;               // 连续超出预算的次数
+    bool isIsolated;                // 是否已被隔离到隔离执行器
+};
+
+struct OwnerInfo {
+    std::atomic<size_t> taskCnt{0}; // 任务数量(含完成回调尚未执行的任务)，供无锁读取
+};
+using TimerUnit = std::chrono::milliseconds;
+
+const int64_t TimerSecond = 1000;
+const int64_t TimerGcd = 1000;
+const int64_t SimulatedEpoch = TimerSecond; // 模拟时钟起始时间戳，非0以区分"未执行"
+const uint32_t WatchdogStrikes = 3;         // 连续超出预算多少次后隔离任务
+
+/**
+ * @brief 系统时钟时间戳(ms)
+ *
+ * @return int64_t
+ */
+inline int64_t systemNow()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+class TimerService {
+public:
+    /**
+     * @brief Construct a new Timer Service object
+     *
+     * @param mode: 时钟模式，simulated模式下时间仅由advance()推进，用于确定性的快速测试
+     */
+    explicit TimerService(ClockMode mode = ClockMode::real) : m_active(true), m_clockMode(mode)
+    {
+        if (ClockMode::simulated == m_clockMode) {
+            m_now.store(SimulatedEpoch, std::memory_order_release);
+            m_nextTick = SimulatedEpoch;
+            return;
+        }
+        m_thread = std::thread([this]() {
+            while (m_active.load(std::memory_order_acquire)) {
+                execute();
+                TraceLock lock(m_mutex, m_trace);
+                lock.waitFor(m_tickCv, m_gcd, [this]() { return !m_active.load(std::memory_order_acquire); });
+            }
+        });
+    }
+
+    ~TimerService()
+    {
+        if (m_active.exchange(false, std::memory_order_acq_rel)) {
+            {
+                TraceLock lock(m_mutex, m_trace); // 避免唤醒丢失
+            }
+            m_tickCv.notify_all();
+            if (m_thread.joinable()) {
+                m_thread.join();
+            }
+        }
+    };
+
+    TimerService(const TimerService &) = delete;
+    TimerService &operator=(const TimerService &) = delete;
+
+    /**
+     * @brief 进程内共享的定时器服务
+     *
+     * @return std::shared_ptr<TimerService>
+     */
+    static std::shared_ptr<TimerService> instance()
+    {
+        static auto service = std::make_shared<TimerService>();
+        return service;
+    }
+
+    /**
+     * @brief 注册任务所有者(Timer)
+     *
+     * @return std::tuple<OwnerId, const OwnerInfo *>
+     */
+    std::tuple<OwnerId, const OwnerInfo *> attach()
+    {
+        TraceLock lock(m_mutex, m_trace);
+        auto owner = ++m_ownerId;
+        return {owner, &m_owners[owner]};
+    }
+
+    /**
+     * @brief 注销任务所有者，停止其所有任务(不调用完成回调)，并等待正在执行的完成回调及被隔离的任务结束；
+     *        禁止在任务回调中调用
+     *
+     * @param owner: 任务所有者
+     */
+    void detach(OwnerId owner)
+    {
+        TraceLock lock(m_mutex, m_trace);
+        bool isErased = false;
+        for (auto it = m_taskMap.begin(); it != m_taskMap.end();) {
+            if (it->second.owner == owner) {
+                it = eraseTask(it);
+                isErased = true;
+            }
+            else {
+                ++it;
+            }
+        }
+        auto &info = m_owners[owner];
+        lock.wait(m_emptyCv, [&info]() { return info.taskCnt.load(std::memory_order_acquire) == 0; });
+        m_owners.erase(owner);
+        if (isErased) {
+            m_gcd = gcd(); // 因task列表变更，重新计算最大公约数
+        }
+        lock.unlock();
+        m_isolation.cancel(owner); // 锁外等待，被隔离的任务中可能调用定时器接口
+    }
+    /**
+     * @brief 添加定时任务
+     *
+     * @tparam F: 可调用对象模板参数
+     * @tparam Args: 可调用对象参数模板参数
+     * @tparam Ret: 可调用对象返回值
+     * @param mode: 定时器模式
+     * @param policy: 参数传递策略，见ArgPolicy
+     * @param owner: 任务所有者
+     * @param isFut: 是否获取返回值
+     * @param interval: 间隔
+     * @param span: 有效时间
+     * @param f: 可调用对象
+     * @param args: 可调用对象参数
+     * @return std::tuple<TaskId, std::optional<std::future<Ret>>>
+     */
+    template <TaskMode mode, ArgPolicy policy = ArgPolicy::copy, typename F, typename... Args,
+              typename Ret = std::invoke_result_t<F, Args...>>
+    std::tuple<TaskId, std::future<Ret>> addTask(OwnerId owner, int64_t interval, int64_t span, F &&f,
+                                                 Args &&...args)
+    {
+        auto [task, fut] = makeTask<mode, policy>(std::forward<F>(f), std::forward<Args>(args)...);
+        auto id = getTaskId();
+
+        TraceLock lock(m_mutex, m_trace);
+        insertTask(id, TaskInfo{mode, interval, span, 0, 0, 0, TaskStatus::notStarted, std::move(task), nullptr, 0,
+                                owner, 0, 0, false});
+        trace(TraceType::taskAdd, id);
+        return {id, std::move(fut)};
+    }
+
+    /**
+     * @brief 添加结果流定时任务，每次执行的返回值写入有界无锁环形缓冲区，由消费者读取
+     *
+     * @tparam mode: 定时器模式，不支持singleFuture
+     * @tparam policy: 参数传递策略，见ArgPolicy
+     * @param owner: 任务所有者
+     * @param interval: 间隔
+     * @param span: 有效时间
+     * @param capacity: 结果流容量
+     * @param overflow: 结果流溢出策略
+     * @param f: 可调用对象
+     * @param args: 可调用对象参数
+     * @return std::tuple<TaskId, std::shared_ptr<ResultStream<Ret>>>
+     */
+    template <TaskMode mode, ArgPolicy policy = ArgPolicy::copy, typename F, typename... Args,
+              typename Ret = std::invoke_result_t<F, Args...>>
+    std::tuple<TaskId, std::shared_ptr<ResultStream<Ret>>> addStreamTask(OwnerId owner, int64_t interval, int64_t span,
+                                                                         size_t capacity, OverflowPolicy overflow,
+                                                                         F &&f, Args &&...args)
+    {
+        auto stream = std::make_shared<ResultStream<Ret>>(capacity, overflow);
+        auto task = std::make_unique<StreamTask<Ret, mode, policy>>(stream, std::forward<F>(f),
+                                                                    std::forward<Args>(args)...);
+        auto id = getTaskId();
+
+        TraceLock lock(m_mutex, m_trace);
+        insertTask(id, TaskInfo{mode, interval, span, 0, 0, 0, TaskStatus::notStarted, std::move(task), nullptr, 0,
+                                owner, 0, 0, false});
+        trace(TraceType::taskAdd, id);
+        return {id, std::move(stream)};
+    }
+
+    /**
+     * @brief 添加批量定时任务，同一所有者中回调相同的任务组成一组，同一tick内到期的任务参数按任务id顺序
+     *        收集到连续内存中，在该tick的单个任务执行完后调用一次回调
+     *
+     * @tparam mode: 定时器模式，不支持singleFuture
+     * @tparam Arg: 任务参数类型
+     * @param owner: 任务所有者
+     * @param interval: 间隔
+     * @param span: 有效时间
+     * @param f: 批量回调，参数为到期任务参数的首地址和数量
+     * @param arg: 任务参数
+     * @return TaskId
+     */
+    template <TaskMode mode, typename Arg>
+    TaskId addBatchTask(OwnerId owner, int64_t interval, int64_t span, void (*f)(const Arg *, size_t),
+                        std::decay_t<Arg> arg)
+    {
+        static_assert(TaskMode::singleFuture != mode, "Batch task can not return future!");
+        auto id = getTaskId();
+
+        TraceLock lock(m_mutex, m_trace);
+        auto &batch = m_batchMap[{owner, reinterpret_cast<void *>(f)}];
+        if (!batch) {
+            batch = std::make_unique<Batch<Arg>>(f, &m_dueBatches);
+        }
+        auto task = std::make_unique<BatchTask<Arg>>(static_cast<Batch<Arg> &>(*batch), std::move(arg));
+        insertTask(id, TaskInfo{mode, interval, span, 0, 0, 0, TaskStatus::notStarted, std::move(task), nullptr, 0,
+                                owner, 0, 0, false});
+        trace(TraceType::taskAdd, id);
+        return id;
+    }
+
+    /**
+     * @brief 控制任务启动/停止/暂停
+     *
+     * @param owner 任务所有者
+     * @param id task id
+     * @param control TaskControl
+     */
+    void control(OwnerId owner, TaskId id, TaskControl control)
+    {
+        TraceLock lock(m_mutex, m_trace);
+        trace(TraceType::taskControl, id, static_cast<uint8_t>(control));
+        auto it = m_taskMap.find(id);
+        if (it != m_taskMap.end() && it->second.owner == owner) {
+            switch (control) {
+            case TaskControl::start: {
+                it->second.status = TaskStatus::running;
+                it->second.startTime = now();
+                m_deadlines.update(it->second.slot, nextDeadline(it->second));
+            } break;
+            case TaskControl::stop:
+                eraseTask(it);
+                break;
+            default:
+                break;
+            }
+            m_gcd = gcd(); // 因task列表变更，重新计算最大公约数
+        }
+        else {
+            std::cerr << "Task not found!" << std::endl;
+        }
+    }
+
+    /**
+     * @brief 服务中所有任务的数量，无锁读取，不与定时器线程竞争
+     *
+     * @return size_t
+     */
+    size_t taskCount() const { return m_taskCnt.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 阻塞等待任务所有者的任务列表为空，替代轮询isTaskEmpty()；返回true时已完成任务的完成回调均已执行；
+     *        simulated模式下时间仅由advance()推进，需由其他线程驱动advance()，timeout为真实时间，为0时立即返回是否为空
+     *
+     * @param owner: 任务所有者
+     * @param timeout: 超时时间(ms)，小于0表示一直等待
+     * @return true: 任务列表已为空
+     * @return false: 等待超时
+     */
+    bool waitUntilEmpty(OwnerId owner, int64_t timeout = -1)
+    {
+        TraceLock lock(m_mutex, m_trace);
+        const auto &info = m_owners[owner];
+        auto isEmpty = [&info]() { return info.taskCnt.load(std::memory_order_acquire) == 0; };
+        if (timeout < 0) {
+            lock.wait(m_emptyCv, isEmpty);
+            return true;
+        }
+        return lock.waitFor(m_emptyCv, timeout, isEmpty);
+    }
+
+    /**
+     * @brief 设置任务完成回调，span/single/singleFuture模式的任务自然完成后在定时器线程(锁外)调用；
+     *        通过TaskControl::stop停止的任务不会回调，period模式的任务永远不会完成
+     *
+     * @param owner: 任务所有者
+     * @param id: task id
+     * @param cb: 完成回调，参数为完成的task id
+     */
+    void onFinished(OwnerId owner, TaskId id, FinishedCallback cb)
+    {
+        TraceLock lock(m_mutex, m_trace);
+        auto it = m_taskMap.find(id);
+        if (it != m_taskMap.end() && it->second.owner == owner) {
+            it->second.onFinished = std::move(cb);
+        }
+        else {
+            std::cerr << "Task not found!" << std::endl;
+        }
+    }
+
+    /**
+     * @brief 设置任务单次执行的时间预算，连续超出预算的任务被隔离到单独的线程执行，保证其他任务的精度；
+     *        被隔离的任务共享一个线程，其中长期阻塞的任务会使其他被隔离的任务的执行被丢弃；
+     *        批量任务不支持
+     *
+     * @param owner: 任务所有者
+     * @param id: task id
+     * @param budget: 时间预算(us)，覆盖setWatchdog()设置的默认预算，0表示不检测
+     */
+    void setBudget(OwnerId owner, TaskId id, int64_t budget)
+    {
+        TraceLock lock(m_mutex, m_trace);
+        auto it = m_taskMap.find(id);
+        if (it == m_taskMap.end() || it->second.owner != owner) {
+            std::cerr << "Task not found!" << std::endl;
+        }
+        else if (!it->second.task->isIsolatable()) {
+            std::cerr << "Batch task can not be isolated!" << std::endl;
+        }
+        else {
+            it->second.budget = budget;
+        }
+    }
+
+    /**
+     * @brief 配置看门狗
+     *
+     * @param strikes: 连续超出预算多少次后隔离任务
+     * @param hook: 任务超出预算时在定时器线程(持锁)中调用，禁止在其中调用定时器接口；为空时仅在隔离任务时输出日志
+     * @param defaultBudget: 此后添加的任务(批量任务除外)默认的时间预算(us)，0表示不检测
+     */
+    void setWatchdog(uint32_t strikes, WatchdogHook hook, int64_t defaultBudget = 0)
+    {
+        TraceLock lock(m_mutex, m_trace);
+        m_strikes = std::max<uint32_t>(strikes, 1);
+        m_watchdogHook = std::move(hook);
+        m_defaultBudget = defaultBudget;
+    }
+
+    /**
+     * @brief 看门狗统计
+     *
+     * @return WatchdogStats
+     */
+    WatchdogStats watchdogStats() const
+    {
+        return WatchdogStats{m_overBudgetCnt.load(std::memory_order_relaxed),
+                             m_isolatedCnt.load(std::memory_order_relaxed),
+                             m_isolatedFire.load(std::memory_order_relaxed),
+                             m_skippedFire.load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * @brief 推进模拟时钟，按真实定时器线程的tick顺序(执行后间隔最大公约数)依次执行到期任务；
+     *        仅ClockMode::simulated可用，且只能由一个线程驱动
+     *
+     * @param duration: 推进的时间(ms)，不能为负数
+     */
+    void advance(int64_t duration)
+    {
+        if (ClockMode::simulated != m_clockMode) {
+            std::cerr << "Timer is not simulated!" << std::endl;
+            return;
+        }
+        if (duration < 0) {
+            std::cerr << "Simulated clock can not go backwards!" << std::endl;
+            return;
+        }
+        int64_t target = m_now.load(std::memory_order_acquire) + duration;
+        while (m_nextTick <= target) {
+            m_now.store(m_nextTick, std::memory_order_release);
+            execute();
+            TraceLock lock(m_mutex, m_trace);
+            m_nextTick += m_gcd;
+            notifyClock();
+        }
+        m_now.store(target, std::memory_order_release);
+        TraceLock lock(m_mutex, m_trace);
+        notifyClock();
+    }
+
+    /**
+     * @brief 注册时钟推进通知，simulated模式下advance()每次tick及结束时在持锁状态下调用，
+     *        用于唤醒按模拟时钟等待的线程(如DelayQueue::pop())；通知中禁止调用定时器接口
+     *
+     * @param cb: 通知回调
+     * @return uint32_t: 通知ID，用于removeClockListener()
+     */
+    uint32_t addClockListener(std::function<void()> cb)
+    {
+        TraceLock lock(m_mutex, m_trace);
+        auto id = ++m_listenerId;
+        m_clockListeners.emplace(id, std::move(cb));
+        return id;
+    }
+
+    /**
+     * @brief 注销时钟推进通知，返回后通知不会再被调用
+     *
+     * @param id: 通知ID
+     */
+    void removeClockListener(uint32_t id)
+    {
+        TraceLock lock(m_mutex, m_trace);
+        m_clockListeners.erase(id);
+    }
+
+    /**
+     * @brief 当前时间戳(ms)，simulated模式下为模拟时钟
+     *
+     * @return int64_t
+     */
+    int64_t now() const
+    {
+        if (ClockMode::simulated == m_clockMode) {
+            return m_now.load(std::memory_order_acquire);
+        }
+        return systemNow();
+    }
+
+    ClockMode clockMode() const { return m_clockMode; }
+
+    /**
+     * @brief 开启事件追踪，开启后不可关闭，重复调用无效
+     *
+     * @param capacity: 保存的事件数量，写满后覆盖最旧的事件
+     */
+    void enableTrace(size_t capacity)
+    {
+        auto ring = std::make_unique<TraceRing>(capacity);
+        TraceRing *expected = nullptr;
+        if (m_trace.compare_exchange_strong(expected, ring.get(), std::memory_order_acq_rel)) {
+            m_traceRing = std::move(ring);
+        }
+    }
+
+    /**
+     * @brief 以二进制格式导出追踪事件，可由sample/tools/traceToChrome转换为Chrome trace JSON
+     *
+     * @param os: 输出流
+     */
+    void dumpTrace(std::ostream &os) const
+    {
+        if (auto *ring = m_trace.load(std::memory_order_acquire)) {
+            writeTrace(ring->snapshot(), os);
+        }
+        else {
+            writeTrace({}, os);
+        }
+    }
+
+private:
+    /**
+     * @brief 记录追踪事件，未开启追踪时仅有一次原子读取
+     *
+     * @param type: 事件类型
+     * @param id: task id
+     * @param arg: 事件参数
+     */
+    void trace(TraceType type, TaskId id, uint8_t arg = 0)
+    {
+        if (auto *ring = m_trace.load(std::memory_order_acquire)) {
+            ring->record(type, id, arg);
+        }
+    }
+
+    /**
+     * @brief 调用时钟推进通知，调用者需持有m_mutex
+     *
+     */
+    void notifyClock()
+    {
+        for (auto &[id, cb] : m_clockListeners) {
+            cb();
+        }
+    }
+
+    /**
+     * @brief 执行任务，设置了时间预算的任务检测耗时，连续超出预算的任务被隔离，之后转到隔离执行器中执行
+     *
+     * @param id: task id
+     * @param info: task info
+     */
+    void fire(TaskId id, TaskInfo &info)
+    {
+        if (info.isIsolated) {
+            if (m_isolation.post(info.owner, id, info.task)) { // 由隔离执行器记录taskFire/callbackEnd
+                m_isolatedFire.fetch_add(1, std::memory_order_relaxed);
+            }
+            else {
+                m_skippedFire.fetch_add(1, std::memory_order_relaxed);
+            }
+            return;
+        }
+
+        trace(TraceType::taskFire, id);
+        if (info.budget <= 0) {
+            info.task->execute();
+            trace(TraceType::callbackEnd, id);
+            return;
+        }
+        auto begin = std::chrono::steady_clock::now();
+        info.task->execute();
+        auto cost =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+        trace(TraceType::callbackEnd, id);
+        if (cost <= info.budget) {
+            info.overCnt = 0;
+            return;
+        }
+
+        m_overBudgetCnt.fetch_add(1, std::memory_order_relaxed);
+        if (++info.overCnt >= m_strikes) {
+            info.isIsolated = true;
+            m_isolatedCnt.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (m_watchdogHook) {
+            m_watchdogHook(id, cost, info.isIsolated);
+        }
+        else if (info.isIsolated) {
+            std::cerr << "Task " << id << " isolated, cost: " << cost << "us budget: " << info.budget << "us"
+                      << std::endl;
+        }
+    }
+
+    /**
+     * @brief 执行所有定时任务
+     *
+     */
+    void execute()
+    {
+        std::vector<std::tuple<OwnerId, TaskId, FinishedCallback>> finished; // 锁外调用的完成回调
+        TraceLock lock(m_mutex, m_trace);
+        trace(TraceType::tickBegin, 0);
+        bool isFinished = false;
+        int64_t curStamp = now();
+        m_deadlines.collectDue(curStamp, m_dueIds);
+        std::sort(m_dueIds.begin(), m_dueIds.end()); // 与按id遍历任务列表的执行顺序保持一致
+        for (auto dueId : m_dueIds) {
+            auto it = m_taskMap.find(dueId);
+            auto &[id, info] = *it;
+            auto [isEx, isFin] = isExecuteAndFinished(info, curStamp);
+            if (isEx) {
+                fire(id, info);
+            }
+            if (isFin) {
+                if (info.isIsolated) {
+                    // 被隔离的任务可能仍在隔离执行器中执行，由隔离执行器在其执行结束后调用完成回调并减少任务数量
+                    m_isolation.defer(info.owner, id, [this, owner = info.owner, id = id, cb = std::move(info.onFinished)]() {
+                        if (cb) {
+                            cb(id);
+                        }
+                        TraceLock lock(m_mutex, m_trace);
+                        releaseOwner(owner);
+                    });
+                    eraseTask(it, false);
+                }
+                else if (info.onFinished) {
+                    // 完成回调执行后才减少所有者的任务数量，保证waitUntilEmpty()返回时回调已执行
+                    finished.emplace_back(info.owner, id, std::move(info.onFinished));
+                    eraseTask(it, false);
+                }
+                else {
+                    eraseTask(it);
+                }
+                isFinished = true;
+            }
+            else {
+                m_deadlines.update(info.slot, nextDeadline(info));
+            }
+        }
+        for (auto *batch : m_dueBatches) {
+            batch->flush();
+            releaseBatch(batch); // 本tick完成的任务可能是组内最后一个任务
+        }
+        m_dueBatches.clear();
+        if (isFinished) {
+            m_gcd = gcd(); // 因task列表变更，重新计算最大公约数
+        }
+        trace(TraceType::tickEnd, 0);
+        lock.unlock();
+
+        if (finished.empty()) {
+            return;
+        }
+        for (auto &[owner, id, cb] : finished) {
+            cb(id);
+        }
+        lock.lock();
+        for (auto &[owner, id, cb] : finished) {
+            releaseOwner(owner);
+        }
+    }
+
+    /**
+     * @brief 插入任务，调用者需持有m_mutex
+     *
+     * @param id: task id
+     * @param info: task info
+     */
+    void insertTask(TaskId id, TaskInfo info)
+    {
+        info.slot = m_deadlines.add(id);
+        if (info.task->isIsolatable()) {
+            info.budget = m_defaultBudget;
+        }
+        m_owners[info.owner].taskCnt.fetch_add(1, std::memory_order_release);
+        m_taskMap.emplace(id, std::move(info));
+        m_taskCnt.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 移除任务并更新计数，调用者需持有m_mutex
+     *
+     * @param it: 任务迭代器
+     * @param isRelease: 是否同时减少所有者的任务数量，为false时由调用者稍后调用releaseOwner()
+     * @return std::map<TaskId, TaskInfo>::iterator: 下一个任务
+     */
+    std::map<TaskId, TaskInfo>::iterator eraseTask(std::map<TaskId, TaskInfo>::iterator it, bool isRelease = true)
+    {
+        auto slot = it->second.slot;
+        auto owner = it->second.owner;
+        auto *batch = it->second.task->batch();
+        it = m_taskMap.erase(it);
+        if (batch != nullptr) {
+            releaseBatch(batch);
+        }
+        auto moved = m_deadlines.remove(slot);
+        if (moved != 0) {
+            m_taskMap.find(moved)->second.slot = slot;
+        }
+        m_taskCnt.fetch_sub(1, std::memory_order_release);
+        if (isRelease) {
+            releaseOwner(owner);
+        }
+        return it;
+    }
+
+    /**
+     * @brief 批量任务组中没有任务且没有待处理的参数时释放该组，调用者需持有m_mutex
+     *
+     * @param batch: 批量任务组
+     */
+    void releaseBatch(BatchBase *batch)
+    {
+        if (batch->taskCnt != 0 || batch->isDue()) {
+            return;
+        }
+        auto it = std::find_if(m_batchMap.begin(), m_batchMap.end(),
+                               [batch](const auto &item) { return item.second.get() == batch; });
+        m_batchMap.erase(it);
+    }
+
+    /**
+     * @brief 减少所有者的任务数量，任务列表为空时唤醒waitUntilEmpty()，调用者需持有m_mutex
+     *
+     * @param owner: 任务所有者
+     */
+    void releaseOwner(OwnerId owner)
+    {
+        if (m_owners[owner].taskCnt.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_emptyCv.notify_all();
+        }
+    }
+
+    /**
+     * @brief 计算任务下一次需要判断是否执行/完成的时间，与isExecuteAndFinished()的判断条件一致
+     *
+     * @param info: task info
+     * @return int64_t
+     */
+    int64_t nextDeadline(const TaskInfo &info) const
+    {
+        if (info.status != TaskStatus::running) {
+            return DeadlineNever;
+        }
+        if (info.lastExecuteTime == 0) {
+            return info.startTime + info.interval;
+        }
+        int64_t deadline = info.lastExecuteTime + info.interval;
+        if (TaskMode::span == info.mode) {
+            deadline = std::min(deadline, info.startTime + info.span);
+        }
+        return deadline;
+    }
+
+    /**
+     * @brief Get the Task Id object
+     *
+     * @return TaskId
+     */
+    TaskId getTaskId() { return ++m_taskId; };
+
+    /**
+     * @brief 计算最小公倍数
+     *
+     * @return int64_t
+     */
+    int64_t gcd()
+    {
+        bool isFirst = false;
+        int64_t value = 0;
+        for (const auto &[id, info] : m_taskMap) {
+            if (info.status == TaskStatus::running) {
+                if (!isFirst) {
+                    isFirst = true;
+                    value = info.interval;
+                }
+                else {
+                    value = std::gcd(value, info.interval);
+                }
+            }
+        }
+        return (value == 0 || value > TimerGcd) ? TimerGcd : value;
+    };
+
+    /**
+     * @brief 判断task是要执行以及是否任务完成
+     *
+     * @param info: task info
+     * @param curStamp: 当前时间戳
+     * @return std::tuple<bool, bool> first: 是否执行, second: 是否完成
+     */
+    std::tuple<bool, bool> isExecuteAndFinished(TaskInfo &info, int64_t curStamp)
+    {
+        bool isEx = false;
+        bool isFin = false;
+        /* std::cout << "info.startTime: " << info.startTime << " info.lastExecuteTime: " << info.lastExecuteTime
+                  << " info.interval: " << info.interval << " span: " << info.span << " curStamp: " << curStamp <<
+           std::endl;
+         */
+        // 第一次执行
+        if (info.lastExecuteTime == 0 && curStamp - info.startTime >= info.interval) {
+            info.lastExecuteTime = curStamp;
+            info.startTime = curStamp - info.interval; // 矫正因其他Timer导致的误差
+            isEx = true;
+            if (TaskMode::single == info.mode || TaskMode::singleFuture == info.mode ||
+                (TaskMode::span == info.mode && curStamp - info.startTime >= info.span)) {
+                isFin = true;
+            }
+        }
+        else if (info.lastExecuteTime != 0) {
+            if (TaskMode::span == info.mode && curStamp - info.startTime >= info.span) {
+                isFin = true;
+            }
+
+            if (curStamp - info.lastExecuteTime >= info.interval) {
+                info.lastExecuteTime = curStamp;
+                isEx = true;
+            }
+        }
+
+        return {isEx, isFin};
+    };
+
+private:
+    std::atomic<bool> m_active{false};    // 任务管理器是否处于活动状态
+    ClockMode m_clockMode;                // 时钟模式
+    std::atomic<int64_t> m_now{0};        // 模拟时钟当前时间戳
+    int64_t m_nextTick{0};                // 模拟时钟下一次tick的时间戳
+    int64_t m_gcd{TimerGcd};              // 最小公倍数
+    std::atomic<TraceRing *> m_trace{nullptr}; // 事件追踪缓冲区，未开启时为空
+    std::unique_ptr<TraceRing> m_traceRing;    // 事件追踪缓冲区所有权
+    std::mutex m_mutex;                        // 互斥锁，通过TraceLock加锁以记录追踪事件
+    std::map<TaskId, TaskInfo> m_taskMap; // 任务列表
+    DeadlineStore m_deadlines;            // 任务截止时间，用于快速找出到期任务
+    std::vector<TaskId> m_dueIds;         // 本tick到期的任务
+    std::atomic<TaskId> m_taskId{0};      // 递增的任务ID
+    std::atomic<size_t> m_taskCnt{0};     // 任务数量，供无锁读取
+    std::map<OwnerId, OwnerInfo> m_owners; // 任务所有者
+    OwnerId m_ownerId{0};                  // 递增的任务所有者ID
+    std::map<std::pair<OwnerId, void *>, std::unique_ptr<BatchBase>> m_batchMap; // 批量任务组，按所有者和回调区分
+    std::vector<BatchBase *> m_dueBatches;                                     // 本tick有到期任务的批量任务组
+    uint32_t m_strikes{WatchdogStrikes};           // 连续超出预算多少次后隔离任务
+    WatchdogHook m_watchdogHook;                   // 超出预算回调
+    int64_t m_defaultBudget{0};                    // 新任务默认的时间预算(us)
+    std::atomic<uint64_t> m_overBudgetCnt{0};      // 超出预算的执行次数
+    std::atomic<uint64_t> m_isolatedCnt{0};        // 被隔离的任务数
+    std::atomic<uint64_t> m_isolatedFire{0};       // 在隔离执行器中执行的次数
+    std::atomic<uint64_t> m_skippedFire{0};        // 隔离任务上一次执行未完成而丢弃的次数
+    Executor m_isolation{m_trace};                 // 隔离执行器
+    std::map<uint32_t, std::function<void()>> m_clockListeners; // 模拟时钟推进通知
+    uint32_t m_listenerId{0};                                   // 递增的通知ID
+    std::condition_variable m_tickCv;  // 定时器线程等待下一次tick
+    std::condition_variable m_emptyCv; // 任务列表为空通知
+    std::thread m_thread;
+};
+}; // namespace vcTimer
+#endif
\ No newline at end of file
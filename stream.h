@@ -0,0 +1,196 @@
+/**
+ * @file stream.h
+ * @author vc (VchaseNi@gmail.com)
+ * @brief 结果流，period/span任务每次执行的返回值写入有界无锁环形缓冲区，由消费者线程批量读取
+ *        备注：
+ *          1. 基于每个槽位序号的有界MPMC队列，生产者为定时器线程(或隔离执行器)，消费者可为多个线程；
+ *          2. 缓冲区满时按溢出策略丢弃最旧或最新的结果，并计入dropped()；
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __VC_STREAM__
+#define __VC_STREAM__
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace vcTimer {
+// 溢出策略
+enum class OverflowPolicy {
+    dropOldest = 0, // 丢弃最旧的结果
+    dropNewest = 1, // 丢弃最新的结果
+};
+
+template <typename T>
+class ResultStream {
+    static_assert(!std::is_reference_v<T>, "Result stream can not hold references!");
+
+public:
+    /**
+     * @brief Construct a new Result Stream object
+     *
+     * @param capacity: 容量，向上取整为2的幂
+     * @param policy: 溢出策略
+     */
+    ResultStream(size_t capacity, OverflowPolicy policy) : m_policy(policy)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_cells = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; i++) {
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ResultStream(const ResultStream &) = delete;
+    ResultStream &operator=(const ResultStream &) = delete;
+
+    /**
+     * @brief 写入结果，缓冲区满时按溢出策略处理
+     *
+     * @param value: 结果
+     * @return true: 写入成功
+     * @return false: dropNewest策略下缓冲区已满，结果被丢弃
+     */
+    bool push(T value)
+    {
+        while (!tryPush(value)) {
+            if (OverflowPolicy::dropNewest == m_policy) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (popWith([](T &&) {})) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 读取一个结果
+     *
+     * @param value: 输出结果
+     * @return true: 读取成功
+     * @return false: 缓冲区为空
+     */
+    bool tryPop(T &value)
+    {
+        return popWith([&value](T &&result) { value = std::move(result); });
+    }
+
+    /**
+     * @brief 批量读取结果，追加到out末尾
+     *
+     * @param out: 输出结果
+     * @param max: 最多读取的数量
+     * @return size_t: 读取的数量
+     */
+    size_t popBatch(std::vector<T> &out, size_t max = SIZE_MAX)
+    {
+        size_t cnt = 0;
+        while (cnt < max && popWith([&out](T &&result) { out.push_back(std::move(result)); })) {
+            cnt++;
+        }
+        return cnt;
+    }
+
+    /**
+     * @brief 因溢出被丢弃的结果数量
+     *
+     * @return uint64_t
+     */
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    /**
+     * @brief 读取一个结果，直接移动到sink中，不要求T可默认构造
+     *
+     * @param sink: 接收结果的可调用对象
+     * @return true: 读取成功
+     * @return false: 缓冲区为空
+     */
+    template <typename Sink>
+    bool popWith(Sink &&sink)
+    {
+        size_t pos = m_dequeue.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = m_dequeue.load(std::memory_order_relaxed);
+            }
+        }
+        sink(std::move(*cell->value));
+        cell->value.reset();
+        cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 尝试写入结果，成功时value被移走
+     *
+     * @param value: 结果
+     * @return true: 写入成功
+     * @return false: 缓冲区已满
+     */
+    bool tryPush(T &value)
+    {
+        size_t pos = m_enqueue.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = m_enqueue.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value.emplace(std::move(value));
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq{0}; // 槽位序号，等于写入位置时可写，等于写入位置+1时可读
+        std::optional<T> value;     // 结果，不要求T可默认构造
+    };
+
+    std::unique_ptr<Cell[]> m_cells;              // 槽位
+    size_t m_mask{0};                             // 容量-1
+    OverflowPolicy m_policy;                      // 溢出策略
+    alignas(64) std::atomic<size_t> m_enqueue{0}; // 写入位置
+    alignas(64) std::atomic<size_t> m_dequeue{0}; // 读取位置
+    std::atomic<uint64_t> m_dropped{0};           // 丢弃的结果数量
+};
+}; // namespace vcTimer
+#endif
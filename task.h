@@ -10,11 +10,15 @@
  */
 #ifndef __VC_TASK__
 #define __VC_TASK__
+#include "stream.h"
 #include <functional>
 #include <future>
 #include <iostream>
 #include <memory>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace vcTimer {
 // 任务模式
@@ -25,39 +29,179 @@ enum class TaskMode {
     singleFuture = 0x4, // 单次Future,可获取返回值
 };
 
-class TaskBase {
-public:
-    virtual ~TaskBase() = default;
-    virtual void execute() = 0;
+// 参数传递策略
+enum class ArgPolicy {
+    copy = 0, // 每次执行以左值传入保存的参数(默认)，按值接收的参数每次执行都会拷贝(不做编译检查，可用isCopiedPerFire_v判断)
+    cref = 1, // 每次执行以const引用传入保存的参数，周期任务的函数签名会导致每次执行拷贝参数时编译报错
+    move = 2, // 执行时将保存的参数移动到可调用对象，仅用于single/singleFuture模式
 };
 
-template <typename Ret, TaskMode mode>
-class Task : public TaskBase {
-public:
 /**
- * @brief Construct a new Task object
+ * @brief 获取可调用对象的参数列表，重载或模板operator()等无法推导时为void
  *
- * @tparam F: 可调用对象模板参数
- * @tparam Args: 可调用对象参数模板参数
- * @tparam typename: 检查函数返回值
+ */
+template <typename F, typename = void>
+struct CallableArgs {
+    using type = void;
+};
+
+template <typename R, typename... P>
+struct CallableArgs<R (*)(P...)> {
+    using type = std::tuple<P...>;
+};
+
+template <typename R, typename... P>
+struct CallableArgs<R (*)(P...) noexcept> : CallableArgs<R (*)(P...)> {};
+
+template <typename R, typename C, typename... P>
+struct CallableArgs<R (C::*)(P...)> : CallableArgs<R (*)(P...)> {};
+
+template <typename R, typename C, typename... P>
+struct CallableArgs<R (C::*)(P...) const> : CallableArgs<R (*)(P...)> {};
+
+template <typename R, typename C, typename... P>
+struct CallableArgs<R (C::*)(P...) noexcept> : CallableArgs<R (*)(P...)> {};
+
+template <typename R, typename C, typename... P>
+struct CallableArgs<R (C::*)(P...) const noexcept> : CallableArgs<R (*)(P...)> {};
+
+template <typename T>
+struct CallableArgs<std::reference_wrapper<T>> : CallableArgs<T> {};
+
+template <typename F>
+struct CallableArgs<F, std::void_t<decltype(&F::operator())>> : CallableArgs<decltype(&F::operator())> {};
+
+template <typename Tuple>
+struct IsCopiedPerFire : std::false_type {};
+
+template <typename... P>
+struct IsCopiedPerFire<std::tuple<P...>>
+    : std::bool_constant<(... || (!std::is_reference_v<P> && !std::is_trivially_copyable_v<P>))> {};
+
+/**
+ * @brief 可调用对象是否按值接收非平凡拷贝的参数，即周期执行时每次都会拷贝保存的参数
+ *
+ */
+template <typename F>
+inline constexpr bool isCopiedPerFire_v = IsCopiedPerFire<typename CallableArgs<std::decay_t<F>>::type>::value;
+
+/**
+ * @brief 保存可调用对象及参数(按值保存，std::reference_wrapper保存为引用)，按参数传递策略调用；
+ *        C++17/20 使用相同的实现，行为一致
+ *
+ * @tparam policy: 参数传递策略
  * @param f: 可调用对象
  * @param args: 可调用对象参数
+ * @return 无参可调用对象
  */
-#if __cplusplus >= 202002L
-    template <typename F, typename... Args,
-              typename = std::enable_if_t<std::is_same_v<Ret, std::invoke_result_t<F, Args...>>, void>>
-    Task(F &&f, Args &&...args)
-        : m_cb([f = std::forward<F>(f), ... args = std::forward<Args>(args)]() { return std::invoke(f, args...); })
+template <ArgPolicy policy, typename F, typename... Args>
+auto makeInvoker(F &&f, Args &&...args)
+{
+    return [f = std::forward<F>(f), args = std::make_tuple(std::forward<Args>(args)...)]() mutable -> decltype(auto) {
+        if constexpr (ArgPolicy::move == policy) {
+            return std::apply(f, std::move(args));
+        }
+        else if constexpr (ArgPolicy::cref == policy) {
+            return std::apply(f, std::as_const(args));
+        }
+        else {
+            return std::apply(f, args);
+        }
+    };
+}
+
+/**
+ * @brief 无参可调用对象包装，与std::function不同，不要求可调用对象可拷贝，
+ *        因此可保存仅可移动的参数(如std::unique_ptr，配合ArgPolicy::move使用)
+ *
+ * @tparam Ret: 返回值类型
+ */
+template <typename Ret>
+class Invoker {
+public:
+    template <typename F>
+    explicit Invoker(F &&f) : m_impl(std::make_unique<Impl<std::decay_t<F>>>(std::forward<F>(f)))
     {
     }
-#elif __cplusplus >= 201703L
+
+    Ret operator()() { return m_impl->call(); }
+
+private:
+    struct ImplBase {
+        virtual ~ImplBase() = default;
+        virtual Ret call() = 0;
+    };
+
+    template <typename F>
+    struct Impl : ImplBase {
+        explicit Impl(F f) : f(std::move(f)) {}
+        Ret call() override { return f(); }
+        F f;
+    };
+
+    std::unique_ptr<ImplBase> m_impl;
+};
+
+/**
+ * @brief 检查参数传递策略是否适用于任务模式
+ *
+ */
+template <TaskMode mode, ArgPolicy policy, typename F>
+constexpr void checkArgPolicy()
+{
+    constexpr bool isSingle = TaskMode::single == mode || TaskMode::singleFuture == mode;
+    static_assert(ArgPolicy::move != policy || isSingle, "ArgPolicy::move is only for single task!");
+    static_assert(ArgPolicy::cref != policy || isSingle || !isCopiedPerFire_v<F>,
+                  "Periodic task copies by-value arguments on every fire, take them by const reference!");
+}
+
+class BatchBase {
+public:
+    virtual ~BatchBase() = default;
+    virtual void flush() = 0;
+    /**
+     * @brief 本tick是否有待处理的参数
+     *
+     */
+    virtual bool isDue() const = 0;
+
+    size_t taskCnt{0}; // 组内任务数量，为0且没有待处理参数时由定时器服务释放
+};
+
+class TaskBase {
+public:
+    virtual ~TaskBase() = default;
+    virtual void execute() = 0;
+    /**
+     * @brief 是否可以转移到其他线程执行(看门狗隔离)
+     *
+     */
+    virtual bool isIsolatable() const { return true; }
+    /**
+     * @brief 所属批量任务组，非批量任务为空
+     *
+     */
+    virtual BatchBase *batch() const { return nullptr; }
+};
+
+template <typename Ret, TaskMode mode, ArgPolicy policy = ArgPolicy::copy>
+class Task : public TaskBase {
+public:
+    /**
+     * @brief Construct a new Task object
+     *
+     * @tparam F: 可调用对象模板参数
+     * @tparam Args: 可调用对象参数模板参数
+     * @tparam typename: 检查函数返回值
+     * @param f: 可调用对象
+     * @param args: 可调用对象参数
+     */
     template <typename F, typename... Args,
               typename = std::enable_if_t<std::is_same_v<Ret, std::invoke_result_t<F, Args...>>, void>>
-    Task(F &&f, Args &&...args)
-        : m_cb(std::bind(std::forward<F>(f), std::forward<Args>(args)...))
+    Task(F &&f, Args &&...args) : m_cb(makeInvoker<policy>(std::forward<F>(f), std::forward<Args>(args)...))
     {
+        checkArgPolicy<mode, policy, F>();
     }
-#endif
 
     /**
      * @brief 获取异步任务的结果
@@ -76,36 +220,27 @@ public:
     }
 
 private:
-    std::function<Ret()> m_cb;
+    Invoker<Ret> m_cb; // 保存可调用对象
 };
 
-template <typename Ret>
-class Task<Ret, TaskMode::singleFuture> : public TaskBase {
+template <typename Ret, ArgPolicy policy>
+class Task<Ret, TaskMode::singleFuture, policy> : public TaskBase {
 public:
-/**
- * @brief Construct a new Task object
- *
- * @tparam F: 可调用对象模板参数
- * @tparam Args: 可调用对象参数模板参数
- * @tparam typename: 检查函数返回值
- * @param f: 可调用对象
- * @param args: 可调用对象参数
- */
-#if __cplusplus >= 202002L
-    template <typename F, typename... Args,
-              typename = std::enable_if_t<std::is_same_v<Ret, std::invoke_result_t<F, Args...>>, void>>
-    Task(F &&f, Args &&...args)
-        : m_cb([f = std::forward<F>(f), ... args = std::forward<Args>(args)]() { return std::invoke(f, args...); })
-    {
-    }
-#elif __cplusplus >= 201703L
+    /**
+     * @brief Construct a new Task object
+     *
+     * @tparam F: 可调用对象模板参数
+     * @tparam Args: 可调用对象参数模板参数
+     * @tparam typename: 检查函数返回值
+     * @param f: 可调用对象
+     * @param args: 可调用对象参数
+     */
     template <typename F, typename... Args,
               typename = std::enable_if_t<std::is_same_v<Ret, std::invoke_result_t<F, Args...>>, void>>
-    Task(F &&f, Args &&...args)
-        : m_cb(std::bind(std::forward<F>(f), std::forward<Args>(args)...))
+    Task(F &&f, Args &&...args) : m_cb(makeInvoker<policy>(std::forward<F>(f), std::forward<Args>(args)...))
     {
+        checkArgPolicy<TaskMode::singleFuture, policy, F>();
     }
-#endif
     ~Task() override {}
 
     /**
@@ -125,10 +260,125 @@ private:
     std::packaged_task<Ret()> m_cb; // 保存可调用对象
 };
 
+template <typename Ret, TaskMode mode, ArgPolicy policy = ArgPolicy::copy>
+class StreamTask : public TaskBase {
+public:
+    /**
+     * @brief Construct a new Stream Task object，每次执行的返回值写入结果流
+     *
+     * @tparam F: 可调用对象模板参数
+     * @tparam Args: 可调用对象参数模板参数
+     * @param stream: 结果流
+     * @param f: 可调用对象
+     * @param args: 可调用对象参数
+     */
+    template <typename F, typename... Args>
+    StreamTask(std::shared_ptr<ResultStream<Ret>> stream, F &&f, Args &&...args)
+        : m_cb(makeInvoker<policy>(std::forward<F>(f), std::forward<Args>(args)...)), m_stream(std::move(stream))
+    {
+        static_assert(!std::is_void_v<Ret>, "Stream task must return a value!");
+        static_assert(!std::is_reference_v<Ret>, "Stream task must return by value!");
+        static_assert(TaskMode::singleFuture != mode, "Stream task can not return future!");
+        checkArgPolicy<mode, policy, F>();
+    }
+
+    /**
+     * @brief 执行定时任务，返回值写入结果流
+     *
+     */
+    void execute() override { m_stream->push(m_cb()); }
+
+private:
+    Invoker<Ret> m_cb;                             // 保存可调用对象
+    std::shared_ptr<ResultStream<Ret>> m_stream;   // 结果流
+};
+
+/**
+ * @brief 批量任务组，共享同一可调用对象的任务在同一tick到期时，参数被收集到连续内存中，一次调用处理
+ *
+ * @tparam Arg: 参数类型
+ */
+template <typename Arg>
+class Batch : public BatchBase {
+public:
+    using Callback = void (*)(const Arg *, size_t);
+
+    /**
+     * @brief Construct a new Batch object
+     *
+     * @param cb: 批量回调，参数为到期任务参数的首地址和数量
+     * @param dueList: 本tick有待处理参数的批量任务组列表
+     */
+    Batch(Callback cb, std::vector<BatchBase *> *dueList) : m_cb(cb), m_dueList(dueList) {}
+
+    /**
+     * @brief 收集到期任务的参数
+     *
+     * @param arg: 任务参数
+     */
+    void append(const Arg &arg)
+    {
+        if (m_args.empty()) {
+            m_dueList->push_back(this);
+        }
+        m_args.push_back(arg);
+    }
+
+    /**
+     * @brief 以收集到的参数调用一次回调
+     *
+     */
+    void flush() override
+    {
+        m_cb(m_args.data(), m_args.size());
+        m_args.clear(); // 保留容量，后续tick不再分配
+    }
+
+    bool isDue() const override { return !m_args.empty(); }
+
+private:
+    Callback m_cb;                        // 批量回调
+    std::vector<BatchBase *> *m_dueList;  // 待处理批量任务组列表
+    std::vector<Arg> m_args;              // 本tick到期任务的参数
+};
+
+template <typename Arg>
+class BatchTask : public TaskBase {
+public:
+    /**
+     * @brief Construct a new Batch Task object
+     *
+     * @param batch: 所属批量任务组
+     * @param arg: 任务参数
+     */
+    BatchTask(Batch<Arg> &batch, Arg arg) : m_batch(batch), m_arg(std::move(arg)) { m_batch.taskCnt++; }
+
+    ~BatchTask() override { m_batch.taskCnt--; }
+
+    /**
+     * @brief 任务到期，仅收集参数，由所属任务组统一调用
+     *
+     */
+    void execute() override { m_batch.append(m_arg); }
+
+    /**
+     * @brief 参数由定时器线程统一处理，不能转移到其他线程
+     *
+     */
+    bool isIsolatable() const override { return false; }
+
+    BatchBase *batch() const override { return &m_batch; }
+
+private:
+    Batch<Arg> &m_batch; // 所属批量任务组
+    Arg m_arg;           // 任务参数
+};
+
 /**
  * @brief task的工厂函数
  *
  * @tparam mode：定时器模式
+ * @tparam policy：参数传递策略
  * @tparam F：可调用对象模板参数
  * @tparam Args：可调用对象参数模板参数
  * @tparam Ret：可调用对象返回值
@@ -136,10 +386,11 @@ private:
  * @param args：可调用对象参数
  * @return std::unique_ptr<Task<Ret>>
  */
-template <TaskMode mode, typename F, typename... Args, typename Ret = std::invoke_result_t<F, Args...>>
-std::tuple<std::unique_ptr<Task<Ret, mode>>, std::future<Ret>> makeTask(F &&f, Args &&...args)
+template <TaskMode mode, ArgPolicy policy = ArgPolicy::copy, typename F, typename... Args,
+          typename Ret = std::invoke_result_t<F, Args...>>
+std::tuple<std::unique_ptr<Task<Ret, mode, policy>>, std::future<Ret>> makeTask(F &&f, Args &&...args)
 {
-    auto task = std::make_unique<Task<Ret, mode>>(std::forward<F>(f), std::forward<Args>(args)...);
+    auto task = std::make_unique<Task<Ret, mode, policy>>(std::forward<F>(f), std::forward<Args>(args)...);
     return {std::move(task), task->getFuture()};
 }
 }; // namespace vcTimer
@@ -9,6 +9,8 @@
  *             频率低的任务第一次加入到定时器中不会很快的响应；
  *             (eg: 上个任务10s，当前加入100ms任务，那么当前可能会在10s后才执行)；
  *          4. 如对时间精度敏感的任务建议使用单独的定时器来管理；
+ *          5. Timer默认独占一个TimerService(线程)，大量组件使用定时器时可共享TimerService::instance()，
+ *             各Timer的任务互相隔离，Timer析构时停止其所有任务；
  * @version 0.1
  * @date 2025-05-24
  *
@@ -17,65 +19,38 @@
  */
 #ifndef __VC_TIMER__
 #define __VC_TIMER__
-#include "task.h"
-#include <map>
-#include <mutex>
-#include <thread>
-#include <tuple>
-#include <numeric>
+#include "service.h"
 
 namespace vcTimer {
 
-// 任务状态
-enum class TaskStatus {
-    notStarted = 0, // 无状态
-    pausing = 1,    // 暂停
-    running = 2,    // 运行中
-    finished = 3,   // 完成
-};
-
-// 任务控制
-enum class TaskControl {
-    start = 0, // 启动
-    stop = 1,  // 停止
-};
-
-struct TaskInfo {
-    TaskMode mode;                  // 任务模式
-    int64_t interval;               // 间隔时间
-    int64_t span;                   // 周期时间
-    int64_t lastExecuteTime;        // 上次执行时间
-    int64_t firstExecuteTime;       // 第一次执行时间
-    int64_t startTime;              // 启动时间
-    TaskStatus status;              // 任务状态
-    std::unique_ptr<TaskBase> task; // 任务对象
-};
-using TaskId = uint32_t;
-using TimerUnit = std::chrono::milliseconds;
-
-const int64_t TimerSecond = 1000;
-const int64_t TimerGcd = 1000;
-
 class Timer {
 public:
-    Timer() : m_active(true)
+    /**
+     * @brief Construct a new Timer object，独占一个定时器服务
+     *
+     * @param mode: 时钟模式，simulated模式下时间仅由advance()推进，用于确定性的快速测试
+     */
+    explicit Timer(ClockMode mode = ClockMode::real) : Timer(std::make_shared<TimerService>(mode)) {}
+
+    /**
+     * @brief Construct a new Timer object，共享定时器服务，不创建线程
+     *
+     * @param service: 定时器服务，如TimerService::instance()
+     */
+    explicit Timer(std::shared_ptr<TimerService> service) : m_service(std::move(service))
     {
-        m_thread = std::thread([this]() {
-            while (m_active.load(std::memory_order_acquire)) {
-                execute();
-                std::this_thread::sleep_for(std::chrono::milliseconds(m_gcd));
-            }
-        });
+        std::tie(m_owner, m_ownerInfo) = m_service->attach();
     }
 
-    ~Timer()
-    {
-        if (m_active.exchange(false, std::memory_order_acq_rel)) {
-            if (m_thread.joinable()) {
-                m_thread.join();
-            }
-        }
-    };
+    /**
+     * @brief Destroy the Timer object，停止该Timer的所有任务；禁止在任务回调中析构
+     *
+     */
+    ~Timer() { m_service->detach(m_owner); }
+
+    Timer(const Timer &) = delete;
+    Timer &operator=(const Timer &) = delete;
+
     /**
      * @brief 添加定时任务
      *
@@ -83,6 +58,7 @@ public:
      * @tparam Args: 可调用对象参数模板参数
      * @tparam Ret: 可调用对象返回值
      * @param mode: 定时器模式
+     * @param policy: 参数传递策略，见ArgPolicy
      * @param isFut: 是否获取返回值
      * @param interval: 间隔
      * @param span: 有效时间
@@ -90,172 +66,142 @@ public:
      * @param args: 可调用对象参数
      * @return std::tuple<TaskId, std::optional<std::future<Ret>>>
      */
-    template <TaskMode mode, typename F, typename... Args, typename Ret = std::invoke_result_t<F, Args...>>
+    template <TaskMode mode, ArgPolicy policy = ArgPolicy::copy, typename F, typename... Args,
+              typename Ret = std::invoke_result_t<F, Args...>>
     std::tuple<TaskId, std::future<Ret>> addTask(int64_t interval, int64_t span, F &&f, Args &&...args)
     {
-        auto [task, fut] = makeTask<mode>(std::forward<F>(f), std::forward<Args>(args)...);
-        auto id = getTaskId();
+        return m_service->addTask<mode, policy>(m_owner, interval, span, std::forward<F>(f),
+                                                std::forward<Args>(args)...);
+    }
 
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_taskMap.emplace(id, TaskInfo{mode, interval, span, 0, 0, 0, TaskStatus::notStarted, std::move(task)});
-        return {id, std::move(fut)};
+    /**
+     * @brief 添加结果流定时任务，见TimerService::addStreamTask()
+     *
+     * @tparam mode: 定时器模式，不支持singleFuture
+     * @tparam policy: 参数传递策略，见ArgPolicy
+     * @param interval: 间隔
+     * @param span: 有效时间
+     * @param capacity: 结果流容量
+     * @param overflow: 结果流溢出策略
+     * @param f: 可调用对象
+     * @param args: 可调用对象参数
+     * @return std::tuple<TaskId, std::shared_ptr<ResultStream<Ret>>>
+     */
+    template <TaskMode mode, ArgPolicy policy = ArgPolicy::copy, typename F, typename... Args,
+              typename Ret = std::invoke_result_t<F, Args...>>
+    std::tuple<TaskId, std::shared_ptr<ResultStream<Ret>>> addStreamTask(int64_t interval, int64_t span,
+                                                                         size_t capacity, OverflowPolicy overflow,
+                                                                         F &&f, Args &&...args)
+    {
+        return m_service->addStreamTask<mode, policy>(m_owner, interval, span, capacity, overflow, std::forward<F>(f),
+                                                      std::forward<Args>(args)...);
     }
 
     /**
-     * @brief 控制任务启动/停止/暂停
+     * @brief 添加批量定时任务，见TimerService::addBatchTask()
      *
-     * @param id task id
-     * @param control TaskControl
+     * @tparam mode: 定时器模式，不支持singleFuture
+     * @tparam Arg: 任务参数类型
+     * @param interval: 间隔
+     * @param span: 有效时间
+     * @param f: 批量回调，参数为到期任务参数的首地址和数量
+     * @param arg: 任务参数
+     * @return TaskId
      */
-    void control(TaskId id, TaskControl control)
+    template <TaskMode mode, typename Arg>
+    TaskId addBatchTask(int64_t interval, int64_t span, void (*f)(const Arg *, size_t), std::decay_t<Arg> arg)
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        auto it = m_taskMap.find(id);
-        if (it != m_taskMap.end()) {
-            switch (control) {
-            case TaskControl::start: {
-                it->second.status = TaskStatus::running;
-                it->second.startTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-                                           std::chrono::system_clock::now().time_since_epoch())
-                                           .count();
-            } break;
-            case TaskControl::stop:
-                m_taskMap.erase(it);
-                break;
-            default:
-                break;
-            }
-            m_gcd = gcd(); // 因task列表变更，重新计算最大公约数
-        }
-        else {
-            std::cerr << "Task not found!" << std::endl;
-        }
+        return m_service->addBatchTask<mode, Arg>(m_owner, interval, span, f, std::move(arg));
     }
 
+    /**
+     * @brief 控制任务启动/停止/暂停，仅能控制本Timer的任务
+     *
+     * @param id task id
+     * @param control TaskControl
+     */
+    void control(TaskId id, TaskControl control) { m_service->control(m_owner, id, control); }
+
     /**
      * @brief 任务是否为空
      *
      * @return true
      * @return false
      */
-    bool isTaskEmpty()
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_taskMap.empty();
-    }
+    bool isTaskEmpty() const { return taskCount() == 0; }
 
-private:
     /**
-     * @brief 执行所有定时任务
+     * @brief 当前任务数量，无锁读取，不与定时器线程竞争
      *
+     * @return size_t
      */
-    void execute()
-    {
-        bool isFinished = false;
-        std::lock_guard<std::mutex> lock(m_mutex);
-        for (auto it = m_taskMap.begin(); it != m_taskMap.end();) {
-            auto &[id, info] = *it;
-            if (info.status == TaskStatus::running) {
-                auto [isEx, isFin] = isExecuteAndFinished(info, std::chrono::duration_cast<std::chrono::milliseconds>(
-                                                                    std::chrono::system_clock::now().time_since_epoch())
-                                                                    .count());
-                // std::cout << "isEx: " << isEx << " isFin: " << isFin << std::endl;
-                if (isEx) {
-                    info.task->execute();
-                }
-                if (isFin) {
-                    it = m_taskMap.erase(it);
-                    isFinished = true;
-                }
-                else {
-                    it++;
-                }
-            }
-            else {
-                ++it;
-            }
-        }
-        if (isFinished) {
-            m_gcd = gcd(); // 因task列表变更，重新计算最大公约数
-        }
-    }
+    size_t taskCount() const { return m_ownerInfo->taskCnt.load(std::memory_order_acquire); }
 
     /**
-     * @brief Get the Task Id object
+     * @brief 阻塞等待任务列表为空，替代轮询isTaskEmpty()；返回true时完成回调均已执行；
+     *        simulated模式下需由其他线程驱动advance()，见TimerService::waitUntilEmpty()
      *
-     * @return TaskId
+     * @param timeout: 超时时间(ms)，小于0表示一直等待
+     * @return true: 任务列表已为空
+     * @return false: 等待超时
+     */
+    bool waitUntilEmpty(int64_t timeout = -1) { return m_service->waitUntilEmpty(m_owner, timeout); }
+
+    /**
+     * @brief 设置任务完成回调，见TimerService::onFinished()
+     *
+     * @param id: task id
+     * @param cb: 完成回调，参数为完成的task id
      */
-    TaskId getTaskId() { return ++m_taskId; };
+    void onFinished(TaskId id, FinishedCallback cb) { m_service->onFinished(m_owner, id, std::move(cb)); }
 
     /**
-     * @brief 计算最小公倍数
+     * @brief 设置任务单次执行的时间预算，见TimerService::setBudget()；看门狗配置及统计见service()
+     *
+     * @param id: task id
+     * @param budget: 时间预算(us)，覆盖默认预算，0表示不检测
+     */
+    void setBudget(TaskId id, int64_t budget) { m_service->setBudget(m_owner, id, budget); }
+
+    /**
+     * @brief 推进模拟时钟，共享服务时影响所有Timer，见TimerService::advance()
+     *
+     * @param duration: 推进的时间(ms)
+     */
+    void advance(int64_t duration) { m_service->advance(duration); }
+
+    /**
+     * @brief 当前时间戳(ms)，simulated模式下为模拟时钟
      *
      * @return int64_t
      */
-    int64_t gcd()
-    {
-        bool isFirst = false;
-        int64_t value = 0;
-        for (const auto &[id, info] : m_taskMap) {
-            if (info.status == TaskStatus::running) {
-                if (!isFirst) {
-                    isFirst = true;
-                    value = info.interval;
-                }
-                else {
-                    value = std::gcd(value, info.interval);
-                }
-            }
-        }
-        return (value == 0 || value > TimerGcd) ? TimerGcd : value;
-    };
+    int64_t now() const { return m_service->now(); }
 
     /**
-     * @brief 判断task是要执行以及是否任务完成
+     * @brief 开启事件追踪，共享服务时记录所有Timer的事件，见TimerService::enableTrace()
      *
-     * @param info: task info
-     * @param curStamp: 当前时间戳
-     * @return std::tuple<bool, bool> first: 是否执行, second: 是否完成
+     * @param capacity: 保存的事件数量，写满后覆盖最旧的事件
      */
-    std::tuple<bool, bool> isExecuteAndFinished(TaskInfo &info, int64_t curStamp)
-    {
-        bool isEx = false;
-        bool isFin = false;
-        /* std::cout << "info.startTime: " << info.startTime << " info.lastExecuteTime: " << info.lastExecuteTime
-                  << " info.interval: " << info.interval << " span: " << info.span << " curStamp: " << curStamp <<
-           std::endl;
-         */
-        // 第一次执行
-        if (info.lastExecuteTime == 0 && curStamp - info.startTime >= info.interval) {
-            info.lastExecuteTime = curStamp;
-            info.startTime = curStamp - info.interval; // 矫正因其他Timer导致的误差
-            isEx = true;
-            if (TaskMode::single == info.mode || TaskMode::singleFuture == info.mode ||
-                (TaskMode::span == info.mode && curStamp - info.startTime >= info.span)) {
-                isFin = true;
-            }
-        }
-        else if (info.lastExecuteTime != 0) {
-            if (TaskMode::span == info.mode && curStamp - info.startTime >= info.span) {
-                isFin = true;
-            }
+    void enableTrace(size_t capacity) { m_service->enableTrace(capacity); }
 
-            if (curStamp - info.lastExecuteTime >= info.interval) {
-                info.lastExecuteTime = curStamp;
-                isEx = true;
-            }
-        }
+    /**
+     * @brief 以二进制格式导出追踪事件
+     *
+     * @param os: 输出流
+     */
+    void dumpTrace(std::ostream &os) const { m_service->dumpTrace(os); }
 
-        return {isEx, isFin};
-    };
+    /**
+     * @brief 所属的定时器服务
+     *
+     * @return const std::shared_ptr<TimerService>&
+     */
+    const std::shared_ptr<TimerService> &service() const { return m_service; }
 
 private:
-    std::atomic<bool> m_active{false};    // 任务管理器是否处于活动状态
-    int64_t m_gcd{TimerGcd};              // 最小公倍数
-    std::mutex m_mutex;                   // 互斥锁
-    std::map<TaskId, TaskInfo> m_taskMap; // 任务列表
-    std::atomic<TaskId> m_taskId{0};      // 递增的任务ID
-    std::thread m_thread;
+    std::shared_ptr<TimerService> m_service; // 定时器服务
+    OwnerId m_owner{0};                      // 在服务中的所有者ID
+    const OwnerInfo *m_ownerInfo{nullptr};   // 在服务中的所有者信息
 };
 }; // namespace vcTimer
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,335 @@
+/**
+ * @file trace.h
+ * @author vc (VchaseNi@gmail.com)
+ * @brief 定时器事件追踪，用于还原定时器线程的行为(tick、任务执行、加锁等)以分析抖动
+ *        备注：
+ *          1. 事件以16字节二进制格式写入无锁环形缓冲区，写满后覆盖最旧的事件；
+ *          2. 未开启追踪时每个追踪点仅有一次原子读取和分支判断；
+ *          3. 通过Timer::dumpTrace()导出二进制数据，离线使用sample/tools/traceToChrome转换为Chrome trace JSON；
+ * @version 0.1
+ * @date 2025-05-25
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#ifndef __VC_TRACE__
+#define __VC_TRACE__
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace vcTimer {
+// 追踪事件类型
+enum class TraceType : uint8_t {
+    tickBegin = 1,   // tick开始
+    tickEnd = 2,     // tick结束
+    taskFire = 3,    // 任务开始执行
+    callbackEnd = 4, // 任务执行结束
+    taskAdd = 5,     // 添加任务
+    taskControl = 6, // 控制任务，arg为TaskControl
+    lockAcquire = 7, // 获得锁
+    lockRelease = 8, // 释放锁
+};
+
+struct TraceEvent {
+    int64_t stamp;  // 时间戳(ns, steady_clock)
+    uint32_t id;    // task id，与任务无关的事件为0
+    TraceType type; // 事件类型
+    uint8_t arg;    // 事件参数
+    uint16_t tid;   // 线程编号
+};
+static_assert(sizeof(TraceEvent) == 16, "TraceEvent must be compact!");
+
+const uint32_t TraceMagic = 0x52544356; // "VCTR"
+const uint32_t TraceVersion = 1;
+
+/**
+ * @brief 当前线程的编号，从1开始按首次记录事件的顺序分配
+ *
+ * @return uint16_t
+ */
+inline uint16_t traceThreadId()
+{
+    static std::atomic<uint16_t> next{0};
+    thread_local uint16_t tid = ++next;
+    return tid;
+}
+
+class TraceRing {
+public:
+    /**
+     * @brief Construct a new Trace Ring object
+     *
+     * @param capacity: 可保存的事件数量，向上取整为2的幂
+     */
+    explicit TraceRing(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_slots = std::make_unique<Slot[]>(size);
+    }
+
+    /**
+     * @brief 记录事件，可多线程并发调用
+     *
+     * @param type: 事件类型
+     * @param id: task id
+     * @param arg: 事件参数
+     */
+    void record(TraceType type, uint32_t id, uint8_t arg = 0)
+    {
+        uint64_t idx = m_head.fetch_add(1, std::memory_order_relaxed);
+        auto &slot = m_slots[idx & m_mask];
+        auto stamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now().time_since_epoch())
+                         .count();
+        uint64_t meta = static_cast<uint64_t>(id) | static_cast<uint64_t>(type) << 32 |
+                        static_cast<uint64_t>(arg) << 40 | static_cast<uint64_t>(traceThreadId()) << 48;
+        // seqlock：写入期间序号为奇数，读取方据此丢弃未写完或已被覆盖的事件
+        slot.seq.store(idx * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.stamp.store(stamp, std::memory_order_relaxed);
+        slot.meta.store(meta, std::memory_order_relaxed);
+        slot.seq.store(idx * 2 + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief 获取缓冲区中完整的事件，按记录顺序排列
+     *
+     * @return std::vector<TraceEvent>
+     */
+    std::vector<TraceEvent> snapshot() const
+    {
+        std::vector<TraceEvent> events;
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        uint64_t begin = head > m_mask + 1 ? head - m_mask - 1 : 0;
+        events.reserve(head - begin);
+        for (uint64_t idx = begin; idx < head; idx++) {
+            auto &slot = m_slots[idx & m_mask];
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            int64_t stamp = slot.stamp.load(std::memory_order_relaxed);
+            uint64_t meta = slot.meta.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq != idx * 2 + 2 || slot.seq.load(std::memory_order_relaxed) != seq) {
+                continue;
+            }
+            events.push_back(TraceEvent{stamp, static_cast<uint32_t>(meta), static_cast<TraceType>(meta >> 32),
+                                        static_cast<uint8_t>(meta >> 40), static_cast<uint16_t>(meta >> 48)});
+        }
+        return events;
+    }
+
+    size_t capacity() const { return m_mask + 1; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};  // 事件序号*2+2，写入中为奇数
+        std::atomic<int64_t> stamp{0}; // 时间戳
+        std::atomic<uint64_t> meta{0}; // id | type | arg | tid
+    };
+
+    std::unique_ptr<Slot[]> m_slots;  // 事件槽
+    uint64_t m_mask{0};               // 容量-1
+    std::atomic<uint64_t> m_head{0};  // 下一个事件的序号
+};
+
+/**
+ * @brief 记录加锁/解锁事件的锁守卫，基于std::unique_lock<std::mutex>，可配合std::condition_variable等待；
+ *        未开启追踪时与std::unique_lock相比每次加锁/解锁仅多一次原子读取
+ *
+ */
+class TraceLock {
+public:
+    TraceLock(std::mutex &mutex, const std::atomic<TraceRing *> &ring) : m_lock(mutex), m_ring(ring)
+    {
+        record(TraceType::lockAcquire);
+    }
+
+    ~TraceLock()
+    {
+        if (m_lock.owns_lock()) {
+            record(TraceType::lockRelease);
+        }
+    }
+
+    TraceLock(const TraceLock &) = delete;
+    TraceLock &operator=(const TraceLock &) = delete;
+
+    void lock()
+    {
+        m_lock.lock();
+        record(TraceType::lockAcquire);
+    }
+
+    void unlock()
+    {
+        record(TraceType::lockRelease);
+        m_lock.unlock();
+    }
+
+    /**
+     * @brief 等待条件满足，等待期间释放锁
+     *
+     * @param cv: 条件变量
+     * @param pred: 等待条件
+     */
+    template <typename Predicate>
+    void wait(std::condition_variable &cv, Predicate pred)
+    {
+        record(TraceType::lockRelease);
+        cv.wait(m_lock, std::move(pred));
+        record(TraceType::lockAcquire);
+    }
+
+    /**
+     * @brief 等待条件满足或超时，等待期间释放锁
+     *
+     * @param cv: 条件变量
+     * @param timeout: 超时时间(ms)
+     * @param pred: 等待条件
+     * @return true: 条件满足
+     * @return false: 超时
+     */
+    template <typename Predicate>
+    bool waitFor(std::condition_variable &cv, int64_t timeout, Predicate pred)
+    {
+        record(TraceType::lockRelease);
+        bool ret = cv.wait_for(m_lock, std::chrono::milliseconds(timeout), std::move(pred));
+        record(TraceType::lockAcquire);
+        return ret;
+    }
+
+private:
+    void record(TraceType type)
+    {
+        if (auto *ring = m_ring.load(std::memory_order_acquire)) {
+            ring->record(type, 0);
+        }
+    }
+
+private:
+    std::unique_lock<std::mutex> m_lock;
+    const std::atomic<TraceRing *> &m_ring;
+};
+
+/**
+ * @brief 以二进制格式导出事件
+ *
+ * @param events: 事件
+ * @param os: 输出流
+ */
+inline void writeTrace(const std::vector<TraceEvent> &events, std::ostream &os)
+{
+    uint64_t cnt = events.size();
+    os.write(reinterpret_cast<const char *>(&TraceMagic), sizeof(TraceMagic));
+    os.write(reinterpret_cast<const char *>(&TraceVersion), sizeof(TraceVersion));
+    os.write(reinterpret_cast<const char *>(&cnt), sizeof(cnt));
+    os.write(reinterpret_cast<const char *>(events.data()), cnt * sizeof(TraceEvent));
+}
+
+/**
+ * @brief 读取二进制格式的事件
+ *
+ * @param is: 输入流
+ * @param events: 输出事件
+ * @return true: 读取成功
+ * @return false: 格式错误
+ */
+inline bool readTrace(std::istream &is, std::vector<TraceEvent> &events)
+{
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t cnt = 0;
+    is.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+    is.read(reinterpret_cast<char *>(&version), sizeof(version));
+    is.read(reinterpret_cast<char *>(&cnt), sizeof(cnt));
+    if (!is || magic != TraceMagic || version != TraceVersion) {
+        return false;
+    }
+    // 数量来自文件，分块读取，截断或损坏的文件不会按错误的数量一次性分配内存
+    const uint64_t chunk = 4096;
+    events.clear();
+    for (uint64_t done = 0; done < cnt;) {
+        uint64_t size = std::min(chunk, cnt - done);
+        events.resize(done + size);
+        is.read(reinterpret_cast<char *>(events.data() + done), size * sizeof(TraceEvent));
+        if (!is) {
+            events.clear();
+            return false;
+        }
+        done += size;
+    }
+    return true;
+}
+
+/**
+ * @brief 将事件转换为Chrome trace JSON(chrome://tracing 或 Perfetto 可打开)
+ *
+ * @param events: 事件
+ * @param os: 输出流
+ */
+inline void writeChromeTrace(const std::vector<TraceEvent> &events, std::ostream &os)
+{
+    int64_t base = events.empty() ? 0 : events.front().stamp;
+    for (const auto &event : events) {
+        base = std::min(base, event.stamp); // 多线程记录的事件时间戳不严格递增
+    }
+    os << "{\"traceEvents\":[";
+    bool isFirst = true;
+    for (const auto &event : events) {
+        const char *name = "";
+        const char *phase = "i";
+        switch (event.type) {
+        case TraceType::tickBegin:
+            name = "tick", phase = "B";
+            break;
+        case TraceType::tickEnd:
+            name = "tick", phase = "E";
+            break;
+        case TraceType::taskFire:
+            name = "task", phase = "B";
+            break;
+        case TraceType::callbackEnd:
+            name = "task", phase = "E";
+            break;
+        case TraceType::taskAdd:
+            name = "add";
+            break;
+        case TraceType::taskControl:
+            name = event.arg == 0 ? "start" : "stop";
+            break;
+        case TraceType::lockAcquire:
+            name = "lock", phase = "B";
+            break;
+        case TraceType::lockRelease:
+            name = "lock", phase = "E";
+            break;
+        default:
+            continue;
+        }
+        os << (isFirst ? "" : ",") << "\n{\"name\":\"" << name << "\",\"ph\":\"" << phase
+           << "\",\"pid\":1,\"tid\":" << event.tid << ",\"ts\":" << (event.stamp - base) / 1000 << "."
+           << (event.stamp - base) % 1000 / 100;
+        if (*phase == 'i') {
+            os << ",\"s\":\"t\"";
+        }
+        if (event.id != 0) {
+            os << ",\"args\":{\"id\":" << event.id << "}";
+        }
+        os << "}";
+        isFirst = false;
+    }
+    os << "\n]}\n";
+}
+}; // namespace vcTimer
+#endif